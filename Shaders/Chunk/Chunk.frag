@@ -1,12 +1,14 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_nonuniform_qualifier : require
 
-layout(location = 0) in vec3 inUVW;
+layout(location = 0) in vec2 inUV;
+layout(location = 1) flat in uint inTextureIndex;
 
 layout(location = 0) out vec4 outColor;
 
-layout(binding = 1) uniform sampler2DArray texSampler;
+layout(set = 0, binding = 0) uniform sampler2D textures[];
 
 void main() {
-    outColor = texture(texSampler, inUVW);
+    outColor = texture(textures[nonuniformEXT(inTextureIndex)], inUV);
 }
\ No newline at end of file
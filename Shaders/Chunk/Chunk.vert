@@ -10,9 +10,15 @@ layout(push_constant) uniform MVP {
 layout(location = 0) in vec3 inPosition;
 layout(location = 1) in vec3 inUVW;
 
-layout(location = 0) out vec3 outUVW;
+layout(location = 0) out vec2 outUV;
+// the block vertices store the layer of their face texture in z, counted from textureBase
+layout(location = 1) flat out uint outTextureIndex;
+
+// bindless index of the first block texture
+layout(constant_id = 0) const uint textureBase = 0;
 
 void main() {
     gl_Position =  mvp.view * mvp.position * vec4(inPosition, 1.0);
-    outUVW = inUVW;
+    outUV = inUVW.xy;
+    outTextureIndex = textureBase + uint(inUVW.z + 0.5);
 }
\ No newline at end of file
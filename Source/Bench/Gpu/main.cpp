@@ -0,0 +1,34 @@
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+
+#include "Bench/Harness/BenchHarness.hpp"
+#include "Bench/Suites/UploadSuite/UploadSuite.hpp"
+#include "Core/Threading/ThreadPool/ThreadPool.hpp"
+#include "Graphics/GPU/GPU.hpp"
+#include "Graphics/Memory/MemoryManager/MemoryManager.hpp"
+
+int main(int argc, char *argv[]) {
+  std::optional<cbl::bench::BenchSettings> const settings =
+      cbl::bench::BenchSettings::fromArguments(argc, argv, "upload|texture");
+  if (!settings) {
+    return EXIT_FAILURE;
+  }
+
+  cbl::bench::BenchHarness harness{*settings};
+
+  try {
+    // headless, so it runs on software drivers such as lavapipe as well
+    cbl::gfx::GPU gpu{};
+    cbl::ThreadPool jobs{};
+    cbl::gfx::mem::MemoryManager memory{gpu, jobs};
+
+    cbl::bench::UploadSuite::run(harness, gpu, memory);
+  } catch (std::exception const &exception) {
+    std::cerr << exception.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return harness.finish();
+}
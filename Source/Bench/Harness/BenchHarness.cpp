@@ -0,0 +1,223 @@
+#include "BenchHarness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace cbl::bench {
+namespace {
+void writeJsonString(std::ostream &output, std::string const &value) {
+  output << '"';
+  for (char const &character : value) {
+    if (character == '"' || character == '\\') {
+      output << '\\';
+    }
+    output << character;
+  }
+  output << '"';
+}
+} // namespace
+
+std::optional<BenchSettings> BenchSettings::fromArguments(int const &argc, char *argv[],
+                                                          std::string const &suites) {
+  BenchSettings settings{};
+
+  for (int i = 1; i < argc; i++) {
+    bool const hasValue = i + 1 < argc;
+
+    if (std::strcmp(argv[i], "--suite") == 0 && hasValue) {
+      settings.suite = argv[++i];
+    } else if (std::strcmp(argv[i], "--warmup") == 0 && hasValue) {
+      settings.warmup = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(argv[i], "--repetitions") == 0 && hasValue) {
+      settings.repetitions = static_cast<unsigned int>(std::strtoul(argv[++i], nullptr, 10));
+    } else if (std::strcmp(argv[i], "--json") == 0 && hasValue) {
+      settings.jsonPath = argv[++i];
+    } else {
+      std::cerr << "usage: " << argv[0] << " [--suite <" << suites
+                << ">] [--warmup <count>] [--repetitions <count>] [--json <output.json>]\n";
+      return std::nullopt;
+    }
+  }
+
+  return settings;
+}
+
+BenchHarness::BenchHarness(BenchSettings settings) : mSettings{std::move(settings)} {
+  mSettings.repetitions = std::max(mSettings.repetitions, 1u);
+}
+
+bool BenchHarness::isEnabled(std::string const &suite) const {
+  return mSettings.suite.empty() || mSettings.suite == suite;
+}
+
+BenchResult &BenchHarness::run(std::string const &suite, std::string const &name,
+                               std::function<void()> const &body,
+                               std::function<void()> const &setup) {
+  for (unsigned int i = 0; i < mSettings.warmup; i++) {
+    if (setup) {
+      setup();
+    }
+    body();
+  }
+
+  std::vector<double> samples;
+  samples.reserve(mSettings.repetitions);
+
+  for (unsigned int i = 0; i < mSettings.repetitions; i++) {
+    if (setup) {
+      setup();
+    }
+
+    auto const start = std::chrono::steady_clock::now();
+    body();
+    auto const end = std::chrono::steady_clock::now();
+
+    samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+  }
+
+  return addSamples(suite, name, std::move(samples));
+}
+
+BenchResult &BenchHarness::addSamples(std::string const &suite, std::string const &name,
+                                      std::vector<double> samplesNs) {
+  if (samplesNs.empty()) {
+    throw std::invalid_argument("Benchmark " + suite + "/" + name + " has no samples");
+  }
+
+  std::sort(samplesNs.begin(), samplesNs.end());
+
+  BenchResult result{};
+  result.suite = suite;
+  result.name = name;
+  result.repetitions = static_cast<unsigned int>(samplesNs.size());
+  result.minNs = samplesNs.front();
+  result.meanNs = std::accumulate(samplesNs.begin(), samplesNs.end(), 0.0) /
+                  static_cast<double>(samplesNs.size());
+
+  std::size_t const middle = samplesNs.size() / 2;
+  result.medianNs = samplesNs.size() % 2 == 0
+                        ? (samplesNs[middle - 1] + samplesNs[middle]) / 2.0
+                        : samplesNs[middle];
+
+  // nearest rank, so with few repetitions this is the slowest sample
+  auto const p99Rank = static_cast<std::size_t>(std::ceil(0.99 * samplesNs.size()));
+  result.p99Ns = samplesNs[std::max<std::size_t>(p99Rank, 1) - 1];
+
+  mResults.push_back(result);
+  return mResults.back();
+}
+
+BenchResult &BenchHarness::report(std::string const &suite, std::string const &name,
+                                  std::map<std::string, double> const &counters) {
+  BenchResult result{};
+  result.suite = suite;
+  result.name = name;
+  result.counters = counters;
+
+  mResults.push_back(result);
+  return mResults.back();
+}
+
+void BenchHarness::setContext(std::string const &key, std::string const &value) {
+  mContext[key] = value;
+}
+
+std::vector<BenchResult> const &BenchHarness::getResults() const { return mResults; }
+
+void BenchHarness::printSummary(std::ostream &output) const {
+  output << std::left << std::setw(40) << "benchmark" << std::right << std::setw(14)
+         << "median (us)" << std::setw(14) << "p99 (us)" << "\n";
+
+  for (BenchResult const &result : mResults) {
+    output << std::left << std::setw(40) << (result.suite + "/" + result.name) << std::right;
+
+    if (result.repetitions > 0) {
+      output << std::fixed << std::setprecision(2) << std::setw(14) << result.medianNs / 1000.0
+             << std::setw(14) << result.p99Ns / 1000.0;
+    } else {
+      output << std::setw(14) << "-" << std::setw(14) << "-";
+    }
+
+    for (auto const &[counter, value] : result.counters) {
+      output << "  " << counter << "=" << std::defaultfloat << std::setprecision(6) << value;
+    }
+    output << "\n";
+  }
+}
+
+void BenchHarness::writeJson(std::ostream &output) const {
+  output << "{\n  \"warmup\": " << mSettings.warmup
+         << ",\n  \"repetitions\": " << mSettings.repetitions << ",\n  \"context\": {";
+
+  bool firstContext = true;
+  for (auto const &[key, value] : mContext) {
+    output << (firstContext ? "" : ", ");
+    writeJsonString(output, key);
+    output << ": ";
+    writeJsonString(output, value);
+    firstContext = false;
+  }
+
+  output << "},\n  \"benchmarks\": [";
+
+  output << std::setprecision(17);
+  for (std::size_t i = 0; i < mResults.size(); i++) {
+    BenchResult const &result = mResults[i];
+
+    output << (i == 0 ? "\n" : ",\n") << "    {\"suite\": ";
+    writeJsonString(output, result.suite);
+    output << ", \"name\": ";
+    writeJsonString(output, result.name);
+    output << ", \"repetitions\": " << result.repetitions;
+
+    if (result.repetitions > 0) {
+      output << ", \"median_ns\": " << result.medianNs << ", \"p99_ns\": " << result.p99Ns
+             << ", \"min_ns\": " << result.minNs << ", \"mean_ns\": " << result.meanNs;
+    }
+
+    output << ", \"counters\": {";
+    bool first = true;
+    for (auto const &[counter, value] : result.counters) {
+      output << (first ? "" : ", ");
+      writeJsonString(output, counter);
+      output << ": " << value;
+      first = false;
+    }
+    output << "}}";
+  }
+
+  output << "\n  ]\n}\n";
+}
+
+int BenchHarness::finish() const {
+  if (mResults.empty()) {
+    std::cerr << "no benchmark matches the suite " << mSettings.suite << "\n";
+    return EXIT_FAILURE;
+  }
+
+  for (auto const &[key, value] : mContext) {
+    std::cout << key << ": " << value << "\n";
+  }
+  printSummary(std::cout);
+
+  if (!mSettings.jsonPath.empty()) {
+    std::ofstream json{mSettings.jsonPath, std::ios::trunc};
+    if (!json) {
+      std::cerr << "failed to open " << mSettings.jsonPath << "\n";
+      return EXIT_FAILURE;
+    }
+    writeJson(json);
+  }
+
+  return EXIT_SUCCESS;
+}
+} // namespace cbl::bench
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace cbl::bench {
+// keeps the compiler from removing work whose result is never used
+template <typename T> inline void doNotOptimize(T const &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static char const volatile *sink;
+  sink = reinterpret_cast<char const volatile *>(&value);
+#endif
+}
+
+struct BenchSettings {
+  unsigned int warmup = 3;
+  unsigned int repetitions = 30;
+  // only suites with this name run, every suite runs when empty
+  std::string suite;
+  // results are also written there when set
+  std::string jsonPath;
+
+  // prints the usage, listing suites, and returns nothing when the arguments are not understood
+  [[nodiscard]] static std::optional<BenchSettings> fromArguments(int const &argc, char *argv[],
+                                                                  std::string const &suites);
+};
+
+struct BenchResult {
+  std::string suite;
+  std::string name;
+  // 0 for results that only report counters
+  unsigned int repetitions = 0;
+  double medianNs = 0.0;
+  double p99Ns = 0.0;
+  double minNs = 0.0;
+  double meanNs = 0.0;
+  // values measured alongside the timings, such as sizes or counts
+  std::map<std::string, double> counters;
+};
+
+struct BenchHarness {
+private:
+  BenchSettings mSettings;
+  std::vector<BenchResult> mResults;
+  // describes where the results come from, such as the device
+  std::map<std::string, std::string> mContext;
+
+public:
+  BenchHarness() = delete;
+  explicit BenchHarness(BenchSettings settings);
+  BenchHarness(BenchHarness const &) = delete;
+  ~BenchHarness() = default;
+
+  void operator=(BenchHarness const &) = delete;
+
+  [[nodiscard]] bool isEnabled(std::string const &suite) const;
+
+  // times body once per repetition after the warmup runs, setup runs before every call of body
+  // and is not timed
+  BenchResult &run(std::string const &suite, std::string const &name,
+                   std::function<void()> const &body, std::function<void()> const &setup = {});
+  // records timings measured elsewhere, such as one sample per rendered frame
+  BenchResult &addSamples(std::string const &suite, std::string const &name,
+                          std::vector<double> samplesNs);
+  // records a result without timings
+  BenchResult &report(std::string const &suite, std::string const &name,
+                      std::map<std::string, double> const &counters);
+
+  void setContext(std::string const &key, std::string const &value);
+
+  [[nodiscard]] std::vector<BenchResult> const &getResults() const;
+
+  void printSummary(std::ostream &output) const;
+  void writeJson(std::ostream &output) const;
+  // prints the summary, writes the JSON file if requested and returns the process exit code
+  [[nodiscard]] int finish() const;
+};
+} // namespace cbl::bench
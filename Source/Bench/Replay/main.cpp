@@ -0,0 +1,131 @@
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#define SDL_MAIN_HANDLED
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Bench/Harness/BenchHarness.hpp"
+#include "Core/Input/Input.hpp"
+#include "Core/Input/InputRecording/InputRecording.hpp"
+#include "Game/ChunkMeshSlots/ChunkMeshSlots.hpp"
+#include "Game/Chunks/IOService/ChunkIOService.hpp"
+#include "Game/Chunks/Residency/ChunkResidency.hpp"
+#include "Graphics/Engine/Engine.hpp"
+
+namespace {
+// plays the recording back one simulation step per frame and times every frame
+void replay(cbl::bench::BenchHarness &harness, cbl::InputRecording const &recording) {
+  cbl::gfx::EngineSettings settings{};
+  settings.headless = true;
+  cbl::gfx::Engine engine{settings};
+
+  // freshly generated terrain, so the run does not depend on what an earlier one saved
+  std::filesystem::path const worldDirectory =
+      std::filesystem::temp_directory_path() / "cobblestone_replay";
+  std::filesystem::remove_all(worldDirectory);
+
+  cbl::ChunkIOService chunkIO{worldDirectory};
+  cbl::World world;
+
+  cbl::ChunkResidencySettings residencySettings{};
+  residencySettings.seed = recording.seed;
+  cbl::ChunkResidency residency{chunkIO, residencySettings};
+  cbl::ChunkMeshSlots chunkMeshes{};
+
+  residency.update(world.camera.getState().position);
+  residency.finishLoads();
+  chunkMeshes.sync(residency, world);
+
+  // waiting for the loads every step keeps streaming from depending on disk speed
+  world.onUpdate = [&residency, &chunkMeshes](cbl::World &updatedWorld) {
+    residency.update(updatedWorld.camera.getState().position);
+    residency.finishLoads();
+    chunkMeshes.sync(residency, updatedWorld);
+  };
+
+  engine.loadWorld(world);
+  // no frames, only waits for the pipelines so their creation stays out of the first sample
+  engine.renderFrames(0);
+  cbl::Input::startPlayback(recording);
+
+  std::vector<double> frameTimes;
+  std::vector<double> drawCalls;
+  std::vector<double> triangles;
+  frameTimes.reserve(recording.ticks.size());
+  drawCalls.reserve(recording.ticks.size());
+  triangles.reserve(recording.ticks.size());
+
+  while (!cbl::Input::isPlaybackFinished()) {
+    auto const start = std::chrono::steady_clock::now();
+    engine.renderFrames(1);
+    auto const end = std::chrono::steady_clock::now();
+
+    cbl::gfx::FrameStats const stats = engine.getLastFrameStats();
+    frameTimes.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+    drawCalls.push_back(stats.drawCalls);
+    triangles.push_back(static_cast<double>(stats.triangles));
+  }
+
+  cbl::Input::stopPlayback();
+  engine.unloadWorld();
+
+  auto const mean = [](std::vector<double> const &values) {
+    return std::accumulate(values.begin(), values.end(), 0.0) /
+           static_cast<double>(values.size());
+  };
+
+  harness.addSamples("replay", "frame", frameTimes).counters = {
+      {"frames", static_cast<double>(frameTimes.size())},
+      {"draw_calls_mean", mean(drawCalls)},
+      {"draw_calls_max", *std::max_element(drawCalls.begin(), drawCalls.end())},
+      {"triangles_mean", mean(triangles)},
+      {"triangles_max", *std::max_element(triangles.begin(), triangles.end())},
+  };
+}
+} // namespace
+
+int main(int argc, char *argv[]) {
+  // usage: CobblestoneReplayBench <recording.cbir> [--json <output.json>]
+  if (argc < 2) {
+    std::cerr << "usage: " << argv[0] << " <recording.cbir> [--json <output.json>]\n";
+    return EXIT_FAILURE;
+  }
+
+  // the remaining arguments are the usual benchmark ones
+  std::vector<char *> arguments{argv[0]};
+  arguments.insert(arguments.end(), argv + 2, argv + argc);
+
+  std::optional<cbl::bench::BenchSettings> const settings =
+      cbl::bench::BenchSettings::fromArguments(static_cast<int>(arguments.size()),
+                                               arguments.data(), "replay");
+  if (!settings) {
+    return EXIT_FAILURE;
+  }
+
+  cbl::bench::BenchHarness harness{*settings};
+
+  try {
+    cbl::InputRecording const recording = cbl::InputRecording::load(argv[1]);
+    if (recording.ticks.empty()) {
+      throw std::runtime_error(std::string{argv[1]} + " does not hold any input");
+    }
+
+    harness.setContext("recording", argv[1]);
+    harness.setContext("seed", std::to_string(recording.seed));
+    replay(harness, recording);
+  } catch (std::exception const &exception) {
+    std::cerr << exception.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return harness.finish();
+}
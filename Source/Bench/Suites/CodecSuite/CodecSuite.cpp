@@ -0,0 +1,69 @@
+#include "CodecSuite.hpp"
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Game/Chunks/Codec/ChunkCodec.hpp"
+#include "Game/Chunks/Generator/ChunkGenerator.hpp"
+
+namespace cbl::bench {
+namespace {
+void runBlocks(BenchHarness &harness, std::string const &name, Chunk::Blocks const &blocks) {
+  Chunk::Blocks copy{};
+  harness.run("codec", name + " raw copy", [&copy, &blocks] {
+    copy = blocks;
+    doNotOptimize(copy);
+  });
+
+  std::vector<uint8_t> encoded{};
+  BenchResult &encodeResult = harness.run(
+      "codec", name + " encode", [&encoded, &blocks] { ChunkCodec::encode(blocks, encoded); },
+      [&encoded] { encoded.clear(); });
+  encodeResult.counters["raw_bytes"] = sizeof(Chunk::Blocks);
+  encodeResult.counters["encoded_bytes"] = static_cast<double>(encoded.size());
+  encodeResult.counters["ratio"] =
+      static_cast<double>(sizeof(Chunk::Blocks)) / static_cast<double>(encoded.size());
+
+  Chunk::Blocks decoded{};
+  harness.run("codec", name + " decode", [&encoded, &decoded] {
+    if (ChunkCodec::decode(encoded.data(), encoded.size(), decoded) == 0) {
+      throw std::runtime_error("Failed to decode a chunk encoded by the benchmark");
+    }
+    doNotOptimize(decoded);
+  });
+
+  if (decoded != blocks) {
+    throw std::runtime_error("Chunk codec round trip does not match the original blocks");
+  }
+}
+} // namespace
+
+void CodecSuite::run(BenchHarness &harness) {
+  if (!harness.isEnabled("codec")) {
+    return;
+  }
+
+  // the section the surface goes through, the ones below it are solid and the ones above air
+  ChunkGenerator::Heightmap const heightmap = ChunkGenerator::generateHeightmap(0, 0);
+  Chunk terrain{};
+  ChunkGenerator::fill(terrain, heightmap, 0, heightmap[0][0] / static_cast<int>(Chunk::BlocksY),
+                       0);
+  runBlocks(harness, "terrain", terrain.blocks);
+  runBlocks(harness, "air", Chunk{}.blocks);
+
+  // random blocks barely form runs or repeated columns, the worst case for the codec
+  std::minstd_rand random{1};
+  Chunk::Blocks noise{};
+  for (int x = 0; x < Chunk::BlocksX; x++) {
+    for (int y = 0; y < Chunk::BlocksY; y++) {
+      for (int z = 0; z < Chunk::BlocksZ; z++) {
+        noise[x][y][z] = static_cast<Block::Type>(random() % Block::TypeCount);
+      }
+    }
+  }
+  runBlocks(harness, "random", noise);
+}
+} // namespace cbl::bench
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Bench/Harness/BenchHarness.hpp"
+
+namespace cbl::bench {
+// ChunkCodec against plain copies of Chunk::blocks
+struct CodecSuite {
+public:
+  CodecSuite() = delete;
+
+  static void run(BenchHarness &harness);
+};
+} // namespace cbl::bench
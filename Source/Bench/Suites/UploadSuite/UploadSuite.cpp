@@ -0,0 +1,145 @@
+#include "UploadSuite.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Graphics/Materials/ChunkMaterial/ChunkMaterial.hpp"
+
+namespace cbl::bench {
+namespace {
+// from a typical terrain chunk up to the most faces a chunk can have, and past it
+constexpr uint32_t MeshVertexCounts[]{2048, 16384, 65536};
+constexpr unsigned int BatchSizes[]{1, 8, 32};
+
+// quads like the ones chunks are built from, the content does not matter for the copies
+gfx::Mesh makeMesh(uint32_t const &vertexCount) {
+  std::vector<uint32_t> indices{};
+  std::vector<gfx::Vertex> const vertices(vertexCount, gfx::Vertex{{0.0f}, {0.0f}});
+
+  indices.reserve(vertexCount / 4 * 6);
+  for (uint32_t quad = 0; quad < vertexCount / 4; quad++) {
+    for (uint32_t const &corner : {0u, 1u, 3u, 3u, 2u, 0u}) {
+      indices.push_back(quad * 4 + corner);
+    }
+  }
+
+  return gfx::Mesh{indices, vertices};
+}
+
+void addAllocationStats(BenchResult &result, gfx::mem::MemoryManager const &memory) {
+  VmaStatInfo const total = memory.getAllocationStats().total;
+  result.counters["vma_blocks"] = total.blockCount;
+  result.counters["vma_allocations"] = total.allocationCount;
+  result.counters["vma_used_bytes"] = static_cast<double>(total.usedBytes);
+  result.counters["vma_unused_bytes"] = static_cast<double>(total.unusedBytes);
+}
+
+void addThroughput(BenchResult &result, double const &bytesPerUpload, unsigned int const &batch) {
+  result.counters["batch"] = batch;
+  result.counters["bytes_per_upload"] = bytesPerUpload;
+  result.counters["upload_latency_us"] = result.medianNs / batch / 1000.0;
+  result.counters["mb_per_s"] =
+      bytesPerUpload * batch / (1024.0 * 1024.0) / (result.medianNs / 1e9);
+}
+
+void destroyMeshBuffers(std::vector<gfx::Mesh> &meshes, gfx::mem::MemoryManager &memory) {
+  for (gfx::Mesh &mesh : meshes) {
+    if (mesh.buffer.isValid) {
+      memory.destroyBuffer(mesh.buffer);
+    }
+  }
+}
+
+void runUploads(BenchHarness &harness, gfx::mem::MemoryManager &memory) {
+  for (uint32_t const &vertexCount : MeshVertexCounts) {
+    gfx::Mesh const source = makeMesh(vertexCount);
+    auto const bytes = static_cast<double>(source.getRequiredBufferSize());
+
+    for (unsigned int const &batch : BatchSizes) {
+      std::string const size = std::to_string(vertexCount) + "v x" + std::to_string(batch);
+      std::vector<gfx::Mesh> meshes(batch, source);
+
+      // every upload allocates its buffer, copies through a fresh staging buffer and waits
+      BenchResult &generated = harness.run(
+          "upload", "generateMeshBuffer " + size,
+          [&meshes, &memory] {
+            for (gfx::Mesh &mesh : meshes) {
+              memory.generateMeshBuffer(mesh);
+            }
+          },
+          [&meshes, &memory] { destroyMeshBuffers(meshes, memory); });
+      addThroughput(generated, bytes, batch);
+      addAllocationStats(generated, memory);
+
+      // the buffers of the last run are kept, only the contents are uploaded again
+      BenchResult &updated = harness.run("upload", "updateMeshBuffer " + size, [&meshes, &memory] {
+        for (gfx::Mesh &mesh : meshes) {
+          memory.updateMeshBuffer(mesh);
+        }
+      });
+      addThroughput(updated, bytes, batch);
+
+      destroyMeshBuffers(meshes, memory);
+    }
+  }
+}
+
+void runTextures(BenchHarness &harness, gfx::mem::MemoryManager &memory) {
+  std::vector<std::filesystem::path> const imagePaths{
+      "Assets/grass_block_side.png", "Assets/grass_block_top.png", "Assets/dirt.png"};
+
+  gfx::mem::Texture texture{};
+  auto const destroyTexture = [&texture, &memory] {
+    if (texture.image.image != VK_NULL_HANDLE) {
+      memory.destroyTexture(texture);
+      texture = {};
+    }
+  };
+
+  bool imagesFound = true;
+  for (std::filesystem::path const &imagePath : imagePaths) {
+    imagesFound = imagesFound && std::filesystem::exists(imagePath);
+  }
+
+  // the block assets are only found when running from the repository
+  if (imagesFound) {
+    harness.run(
+        "texture", "createTexture images",
+        [&texture, &memory, &imagePaths] { texture = memory.createTexture(imagePaths, true); },
+        destroyTexture);
+    destroyTexture();
+  }
+
+  if (std::filesystem::exists(gfx::ChunkMaterial::BundlePath)) {
+    gfx::mem::TextureBundle const bundle{gfx::ChunkMaterial::BundlePath};
+
+    BenchResult &result = harness.run(
+        "texture", "createTexture bundle",
+        [&texture, &memory, &bundle] { texture = memory.createTexture(bundle, true); },
+        destroyTexture);
+    result.counters["bytes_per_upload"] = static_cast<double>(bundle.getDataSize());
+    result.counters["mb_per_s"] = static_cast<double>(bundle.getDataSize()) /
+                                  (1024.0 * 1024.0) / (result.medianNs / 1e9);
+    destroyTexture();
+  }
+}
+} // namespace
+
+void UploadSuite::run(BenchHarness &harness, gfx::GPU const &gpu,
+                      gfx::mem::MemoryManager &memory) {
+  VkPhysicalDeviceProperties properties{};
+  vkGetPhysicalDeviceProperties(gpu.physicalDevice, &properties);
+  harness.setContext("device", properties.deviceName);
+  harness.setContext("driver_version", std::to_string(properties.driverVersion));
+  harness.setContext("dedicated", gpu.isDedicated() ? "true" : "false");
+
+  if (harness.isEnabled("upload")) {
+    runUploads(harness, memory);
+  }
+  if (harness.isEnabled("texture")) {
+    runTextures(harness, memory);
+  }
+}
+} // namespace cbl::bench
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "Bench/Harness/BenchHarness.hpp"
+#include "Graphics/GPU/GPU.hpp"
+#include "Graphics/Memory/MemoryManager/MemoryManager.hpp"
+
+namespace cbl::bench {
+// MemoryManager moving data to the GPU through staging: the upload and texture suites
+struct UploadSuite {
+public:
+  UploadSuite() = delete;
+
+  static void run(BenchHarness &harness, gfx::GPU const &gpu, gfx::mem::MemoryManager &memory);
+};
+} // namespace cbl::bench
@@ -0,0 +1,289 @@
+#include "WorldSuite.hpp"
+
+#include <array>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Game/Block/Block.hpp"
+#include "Game/Chunks/Chunk.hpp"
+#include "Game/Chunks/ChunkMap/ChunkMap.hpp"
+#include "Game/Chunks/Generator/ChunkGenerator.hpp"
+#include "Game/Chunks/Grid/ChunkGrid.hpp"
+#include "Game/Chunks/Pool/ChunkPool.hpp"
+
+namespace cbl::bench {
+namespace {
+using Chunks = ChunkMap<Chunk>;
+
+// every other block is solid, which gives the most faces a chunk can have
+Chunk makeCheckerboardChunk() {
+  Chunk chunk{};
+
+  for (int x = 0; x < Chunk::BlocksX; x++) {
+    for (int y = 0; y < Chunk::BlocksY; y++) {
+      for (int z = 0; z < Chunk::BlocksZ; z++) {
+        chunk.blocks[x][y][z] = (x + y + z) % 2 == 0 ? Block::Type::eDirt : Block::Type::eAir;
+      }
+    }
+  }
+
+  return chunk;
+}
+
+// section of the column at (x, z) the surface goes through at its centre
+int getSurfaceSection(int const &x, int const &z) {
+  ChunkGenerator::Heightmap const heightmap = ChunkGenerator::generateHeightmap(x, z);
+  return heightmap[Chunk::BlocksX / 2][Chunk::BlocksZ / 2] / static_cast<int>(Chunk::BlocksY);
+}
+
+Chunk generateSurface(int const &x, int const &z) {
+  return ChunkGenerator::generate(x, getSurfaceSection(x, z), z);
+}
+
+// every section of size by size columns that holds blocks
+Chunks generateUnlinked(int const &size) {
+  Chunks chunks{};
+
+  for (int x = 0; x < size; x++) {
+    for (int z = 0; z < size; z++) {
+      ChunkGenerator::Heightmap const heightmap = ChunkGenerator::generateHeightmap(x, z);
+      for (int y = 0; y <= ChunkGenerator::getTopSection(heightmap); y++) {
+        Chunk chunk{};
+        ChunkGenerator::fill(chunk, heightmap, x, y, z);
+        chunks.insert(x, y, z, std::move(chunk));
+      }
+    }
+  }
+
+  return chunks;
+}
+
+void runGeneration(BenchHarness &harness) {
+  harness.run("generation", "generate", [] { doNotOptimize(ChunkGenerator::generate(3, 2, 5)); });
+
+  BenchResult &column = harness.run("generation", "generateColumn", [] {
+    ChunkGrid chunks{};
+    ChunkGenerator::generateColumn(chunks, 3, 5);
+    doNotOptimize(chunks);
+  });
+  ChunkGrid sampleColumn{};
+  ChunkGenerator::generateColumn(sampleColumn, 3, 5);
+  column.counters["chunks"] = static_cast<double>(sampleColumn.size());
+
+  std::size_t chunkCount = 0;
+  BenchResult &result = harness.run("generation", "generateMany 8x8", [&chunkCount] {
+    ChunkGrid chunks = ChunkGenerator::generateMany(8, 8);
+    chunkCount = chunks.size();
+    doNotOptimize(chunks);
+  });
+  result.counters["columns"] = 64;
+  result.counters["chunks"] = static_cast<double>(chunkCount);
+}
+
+void runMeshing(BenchHarness &harness) {
+  MeshData faces{};
+  harness.run("meshing", "Block::addFace all sides", [&faces] {
+    faces.indices.clear();
+    faces.vertices.clear();
+    for (int side = 0; side < 6; side++) {
+      for (int type = 0; type < Block::TypeCount; type++) {
+        Block::addFace(faces, static_cast<Block::Side>(side), static_cast<Block::Type>(type),
+                       glm::vec3{0.0f});
+      }
+    }
+    doNotOptimize(faces);
+  });
+
+  Chunk terrain = generateSurface(0, 0);
+
+  // the mesh keeps its capacity between rebuilds, so this is the steady state remesh cost
+  harness.run("meshing", "rebuildMesh terrain", [&terrain] { terrain.rebuildMesh(); });
+  harness.run(
+      "meshing", "rebuildMesh terrain first build", [&terrain] { terrain.rebuildMesh(); },
+      [&terrain] { terrain = generateSurface(0, 0); });
+
+  Chunk checkerboard = makeCheckerboardChunk();
+  BenchResult &checkerboardResult = harness.run(
+      "meshing", "rebuildMesh checkerboard", [&checkerboard] { checkerboard.rebuildMesh(); });
+  checkerboardResult.counters["vertices"] = static_cast<double>(checkerboard.mesh.vertices.size());
+
+  // the surface section at the centre of a 3x3 area has a neighbour on every side, so its border
+  // faces get culled
+  ChunkGrid area = ChunkGenerator::generateMany(3, 3);
+  Chunk &centre = *area.find(1, getSurfaceSection(1, 1), 1);
+  harness.run("meshing", "rebuildMesh with neighbours", [&centre] { centre.rebuildMesh(); });
+  // what a chunk pays when a neighbour streams in next to it
+  harness.run("meshing", "rebuild one border with neighbours",
+              [&centre] { centre.rebuild(Chunk::getSideBit(Block::Side::eLeft)); });
+}
+
+void runNeighbours(BenchHarness &harness) {
+  for (int const size : {4, 8, 16}) {
+    Chunks const pristine = generateUnlinked(size);
+    ChunkGrid grid{};
+
+    // every mesh gets built once, which is most of the time spent in generateMany after
+    // generation
+    BenchResult &result = harness.run(
+        "neighbours", "ChunkGrid::insert " + std::to_string(size) + "x" + std::to_string(size),
+        [&grid, &pristine] {
+          pristine.forEach([&grid](int const &x, int const &y, int const &z, Chunk const &chunk) {
+            grid.insert(x, y, z, chunk);
+          });
+          grid.rebuildMeshes();
+        },
+        [&grid] { grid.clear(); });
+    auto const chunkCount = static_cast<double>(pristine.size());
+    result.counters["columns"] = size * size;
+    result.counters["chunks"] = chunkCount;
+    result.counters["median_ns_per_chunk"] = result.medianNs / chunkCount;
+  }
+
+  // a row of columns streaming in along the edge of a loaded area, the chunks already there only
+  // rebuild the border facing the new row
+  ChunkGrid streamed = ChunkGenerator::generateMany(16, 16);
+  std::vector<std::pair<std::array<int, 3>, Chunk>> row{};
+  for (int z = 0; z < 16; z++) {
+    ChunkGrid column{};
+    ChunkGenerator::generateColumn(column, 16, z);
+    column.forEach([&row](int const &posX, int const &posY, int const &posZ, Chunk const &chunk) {
+      row.emplace_back(std::array<int, 3>{posX, posY, posZ}, chunk);
+    });
+  }
+  std::size_t rebuilt = 0;
+
+  BenchResult &rowResult = harness.run(
+      "neighbours", "ChunkGrid::insert row next to 16x16",
+      [&streamed, &row, &rebuilt] {
+        for (auto const &[position, chunk] : row) {
+          streamed.insert(position[0], position[1], position[2], chunk);
+        }
+        rebuilt = streamed.rebuildMeshes();
+      },
+      [&streamed, &row] {
+        for (auto const &[position, chunk] : row) {
+          streamed.erase(position[0], position[1], position[2]);
+        }
+        streamed.rebuildMeshes();
+      });
+  rowResult.counters["columns"] = 16;
+  rowResult.counters["chunks"] = static_cast<double>(row.size());
+  rowResult.counters["rebuilt_chunks"] = static_cast<double>(rebuilt);
+
+  // one lookup per block of a 16x16 area up to the highest terrain, as a world wide block query
+  // would do
+  Chunks const area = generateUnlinked(16);
+  int const sizeX = 16 * static_cast<int>(Chunk::BlocksX);
+  int const sizeZ = 16 * static_cast<int>(Chunk::BlocksZ);
+
+  BenchResult &lookups = harness.run("neighbours", "ChunkMap::getBlock 16x16", [&] {
+    int solid = 0;
+    for (int x = 0; x < sizeX; x++) {
+      for (int z = 0; z < sizeZ; z++) {
+        for (int y = 0; y < ChunkGenerator::TerrainHeight; y++) {
+          solid += area.getBlock(x, y, z) != Block::Type::eAir ? 1 : 0;
+        }
+      }
+    }
+    doNotOptimize(solid);
+  });
+
+  double const lookupCount =
+      static_cast<double>(sizeX) * sizeZ * ChunkGenerator::TerrainHeight;
+  lookups.counters["lookups"] = lookupCount;
+  lookups.counters["median_ns_per_lookup"] = lookups.medianNs / lookupCount;
+}
+
+// chunks loaded, meshed and dropped again the way the residency streams them, from blocks that
+// were already generated so only the chunk and mesh memory differ
+void runStreaming(BenchHarness &harness) {
+  Chunk const terrain = generateSurface(0, 0);
+
+  BenchResult &allocated = harness.run("streaming", "allocated chunks 8x8", [&terrain] {
+    for (int x = 0; x < 8; x++) {
+      for (int z = 0; z < 8; z++) {
+        auto chunk = std::make_unique<Chunk>();
+        chunk->blocks = terrain.blocks;
+        chunk->placeAt(x, 0, z);
+        chunk->rebuildMesh();
+        MeshData mesh = std::move(chunk->mesh);
+        doNotOptimize(mesh);
+      }
+    }
+  });
+  allocated.counters["chunks"] = 64;
+
+  ChunkPool pool{64};
+  BenchResult &pooled = harness.run("streaming", "pooled chunks 8x8", [&pool, &terrain] {
+    for (int x = 0; x < 8; x++) {
+      for (int z = 0; z < 8; z++) {
+        ChunkHandle const handle = pool.acquire();
+        Chunk &chunk = pool.get(handle);
+        chunk.blocks = terrain.blocks;
+        chunk.placeAt(x, 0, z);
+        chunk.rebuildMesh();
+        MeshData mesh = std::move(chunk.mesh);
+        chunk.mesh = pool.takeMesh();
+        doNotOptimize(mesh);
+        pool.recycleMesh(std::move(mesh));
+        pool.release(handle);
+      }
+    }
+  });
+  pooled.counters["chunks"] = 64;
+  pooled.counters["pool_capacity"] = static_cast<double>(pool.getCapacity());
+}
+
+void runMemory(BenchHarness &harness) {
+  ChunkGrid const chunks = ChunkGenerator::generateMany(16, 16);
+
+  double vertices = 0.0;
+  double indices = 0.0;
+  double meshBytes = 0.0;
+  double reservedBytes = 0.0;
+
+  chunks.forEach([&](int const &, int const &, int const &, Chunk const &chunk) {
+    vertices += static_cast<double>(chunk.mesh.vertices.size());
+    indices += static_cast<double>(chunk.mesh.indices.size());
+    meshBytes += static_cast<double>(chunk.mesh.getIndicesSize() + chunk.mesh.getVerticesSize());
+    reservedBytes += static_cast<double>(chunk.getReservedMeshSize());
+  });
+
+  auto const count = static_cast<double>(chunks.size());
+
+  // sections of air are never stored, so this only grows with the terrain surface
+  harness.report("memory", "terrain 16x16",
+                 {{"columns", 256},
+                  {"chunks", count},
+                  {"chunks_per_column", count / 256.0},
+                  {"chunk_bytes", sizeof(Chunk)},
+                  {"blocks_bytes", sizeof(Chunk::Blocks)},
+                  {"vertex_bytes", sizeof(MeshVertex)},
+                  {"vertices_per_chunk", vertices / count},
+                  {"indices_per_chunk", indices / count},
+                  {"faces_per_chunk", indices / 6.0 / count},
+                  {"mesh_bytes_per_chunk", meshBytes / count},
+                  {"reserved_mesh_bytes_per_chunk", reservedBytes / count}});
+}
+} // namespace
+
+void WorldSuite::run(BenchHarness &harness) {
+  if (harness.isEnabled("generation")) {
+    runGeneration(harness);
+  }
+  if (harness.isEnabled("meshing")) {
+    runMeshing(harness);
+  }
+  if (harness.isEnabled("neighbours")) {
+    runNeighbours(harness);
+  }
+  if (harness.isEnabled("streaming")) {
+    runStreaming(harness);
+  }
+  if (harness.isEnabled("memory")) {
+    runMemory(harness);
+  }
+}
+} // namespace cbl::bench
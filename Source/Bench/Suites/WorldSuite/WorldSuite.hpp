@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Bench/Harness/BenchHarness.hpp"
+
+namespace cbl::bench {
+// CPU side of the world: the generation, meshing, neighbours, streaming and memory suites
+struct WorldSuite {
+public:
+  WorldSuite() = delete;
+
+  static void run(BenchHarness &harness);
+};
+} // namespace cbl::bench
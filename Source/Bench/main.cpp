@@ -0,0 +1,29 @@
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+
+#include "Bench/Harness/BenchHarness.hpp"
+#include "Bench/Suites/CodecSuite/CodecSuite.hpp"
+#include "Bench/Suites/WorldSuite/WorldSuite.hpp"
+
+int main(int argc, char *argv[]) {
+  std::optional<cbl::bench::BenchSettings> const settings =
+      cbl::bench::BenchSettings::fromArguments(
+          argc, argv, "generation|meshing|neighbours|streaming|memory|codec");
+  if (!settings) {
+    return EXIT_FAILURE;
+  }
+
+  cbl::bench::BenchHarness harness{*settings};
+
+  try {
+    cbl::bench::WorldSuite::run(harness);
+    cbl::bench::CodecSuite::run(harness);
+  } catch (std::exception const &exception) {
+    std::cerr << exception.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return harness.finish();
+}
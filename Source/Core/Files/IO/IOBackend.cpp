@@ -0,0 +1,142 @@
+#include "IOBackend.hpp"
+
+#include <cerrno>
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <fcntl.h>
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "Core/Files/IO/IoUringBackend/IoUringBackend.hpp"
+#include "Core/Files/IO/ThreadPoolIOBackend/ThreadPoolIOBackend.hpp"
+
+namespace cbl {
+std::unique_ptr<IOBackend> IOBackend::create() {
+  if (IoUringBackend::isSupported()) {
+    return std::make_unique<IoUringBackend>();
+  }
+
+  return std::make_unique<ThreadPoolIOBackend>();
+}
+
+#ifdef _WIN32
+int IOBackend::openFile(std::filesystem::path const &path) {
+  int const fileDescriptor =
+      _wopen(path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+  if (fileDescriptor == -1) {
+    throw std::runtime_error("Failed to open " + path.string());
+  }
+
+  return fileDescriptor;
+}
+
+void IOBackend::closeFile(int const &fileDescriptor) { _close(fileDescriptor); }
+
+int64_t IOBackend::readAt(int const &fileDescriptor, uint8_t *data, uint32_t const &size,
+                          uint64_t const &offset) {
+  // an explicit offset keeps concurrent transfers on the same file independent
+  OVERLAPPED overlapped{};
+  overlapped.Offset = static_cast<DWORD>(offset);
+  overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+  DWORD bytesRead = 0;
+  if (!ReadFile(reinterpret_cast<HANDLE>(_get_osfhandle(fileDescriptor)), data, size, &bytesRead,
+                &overlapped) &&
+      GetLastError() != ERROR_HANDLE_EOF) {
+    return -EIO;
+  }
+
+  return bytesRead;
+}
+
+int64_t IOBackend::writeAt(int const &fileDescriptor, uint8_t const *data, uint32_t const &size,
+                           uint64_t const &offset) {
+  OVERLAPPED overlapped{};
+  overlapped.Offset = static_cast<DWORD>(offset);
+  overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+  DWORD bytesWritten = 0;
+  if (!WriteFile(reinterpret_cast<HANDLE>(_get_osfhandle(fileDescriptor)), data, size,
+                 &bytesWritten, &overlapped)) {
+    return -EIO;
+  }
+
+  return bytesWritten;
+}
+
+int64_t IOBackend::syncFile(int const &fileDescriptor) {
+  return _commit(fileDescriptor) == 0 ? 0 : -errno;
+}
+#else
+int IOBackend::openFile(std::filesystem::path const &path) {
+  int const fileDescriptor = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fileDescriptor == -1) {
+    throw std::runtime_error("Failed to open " + path.string());
+  }
+
+  return fileDescriptor;
+}
+
+void IOBackend::closeFile(int const &fileDescriptor) { close(fileDescriptor); }
+
+int64_t IOBackend::readAt(int const &fileDescriptor, uint8_t *data, uint32_t const &size,
+                          uint64_t const &offset) {
+  uint32_t transferred = 0;
+
+  // short reads only stop at the end of the file
+  while (transferred < size) {
+    ssize_t const result = pread(fileDescriptor, data + transferred, size - transferred,
+                                 static_cast<off_t>(offset + transferred));
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result < 0) {
+      return -errno;
+    }
+    if (result == 0) {
+      break;
+    }
+    transferred += static_cast<uint32_t>(result);
+  }
+
+  return transferred;
+}
+
+int64_t IOBackend::writeAt(int const &fileDescriptor, uint8_t const *data, uint32_t const &size,
+                           uint64_t const &offset) {
+  uint32_t transferred = 0;
+
+  while (transferred < size) {
+    ssize_t const result = pwrite(fileDescriptor, data + transferred, size - transferred,
+                                  static_cast<off_t>(offset + transferred));
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result < 0) {
+      return -errno;
+    }
+    transferred += static_cast<uint32_t>(result);
+  }
+
+  return transferred;
+}
+
+int64_t IOBackend::syncFile(int const &fileDescriptor) {
+  // timestamps are skipped, a grown file size is still flushed along with the data
+  while (fdatasync(fileDescriptor) != 0) {
+    if (errno != EINTR) {
+      return -errno;
+    }
+  }
+
+  return 0;
+}
+#endif
+} // namespace cbl
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace cbl {
+struct IORequest {
+  // eSync flushes the file's data to the disk, it ignores offset, data and size
+  enum class Type { eRead, eWrite, eSync };
+
+  Type type;
+  int fileDescriptor;
+  uint64_t offset;
+  // owned by the caller and must stay alive until the request completes
+  uint8_t *data;
+  uint32_t size;
+  uint64_t userData;
+};
+
+struct IOCompletion {
+  uint64_t userData;
+  // bytes transferred, or a negated errno value
+  int64_t result;
+};
+
+// positional file reads and writes completing out of order
+struct IOBackend {
+  IOBackend() = default;
+  IOBackend(IOBackend const &) = delete;
+  virtual ~IOBackend() = default;
+
+  void operator=(IOBackend const &) = delete;
+
+  // io_uring when the kernel supports it, worker threads otherwise
+  [[nodiscard]] static std::unique_ptr<IOBackend> create();
+
+  [[nodiscard]] static int openFile(std::filesystem::path const &path);
+  static void closeFile(int const &fileDescriptor);
+  // blocking positional transfers, used by backends without native asynchronous I/O
+  [[nodiscard]] static int64_t readAt(int const &fileDescriptor, uint8_t *data,
+                                      uint32_t const &size, uint64_t const &offset);
+  [[nodiscard]] static int64_t writeAt(int const &fileDescriptor, uint8_t const *data,
+                                       uint32_t const &size, uint64_t const &offset);
+  // returns 0, or a negated errno value
+  [[nodiscard]] static int64_t syncFile(int const &fileDescriptor);
+
+  virtual void submit(std::vector<IORequest> const &requests) = 0;
+  // appends finished requests to completions, blocking until at least minCompletions arrived or
+  // nothing is left in flight
+  virtual void wait(std::vector<IOCompletion> &completions, std::size_t const &minCompletions) = 0;
+  [[nodiscard]] virtual std::size_t getPendingCount() const = 0;
+  [[nodiscard]] virtual char const *getName() const = 0;
+};
+} // namespace cbl
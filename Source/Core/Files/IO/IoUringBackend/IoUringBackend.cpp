@@ -0,0 +1,219 @@
+#include "IoUringBackend.hpp"
+
+#include <stdexcept>
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define CBL_HAS_IO_URING
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace cbl {
+#ifdef CBL_HAS_IO_URING
+namespace {
+int setupRing(unsigned int const &entries, io_uring_params &params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+}
+} // namespace
+
+bool IoUringBackend::isSupported() {
+  static bool const supported = []() {
+    io_uring_params params{};
+    int const ringFileDescriptor = setupRing(1, params);
+    if (ringFileDescriptor < 0) {
+      // old kernels, seccomp filters and disabled io_uring all end up here
+      return false;
+    }
+    close(ringFileDescriptor);
+
+    // first feature flag introduced alongside the plain read and write opcodes
+    return (params.features & IORING_FEAT_RW_CUR_POS) != 0;
+  }();
+
+  return supported;
+}
+
+IoUringBackend::IoUringBackend() {
+  io_uring_params params{};
+  mRingFileDescriptor = setupRing(QueueDepth, params);
+  if (mRingFileDescriptor < 0) {
+    throw std::runtime_error("Failed to create an io_uring instance");
+  }
+
+  mSubmissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+  mCompletionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+  // both rings share one mapping on kernels with IORING_FEAT_SINGLE_MMAP
+  bool const singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (singleMapping) {
+    mSubmissionRingSize = std::max(mSubmissionRingSize, mCompletionRingSize);
+    mCompletionRingSize = mSubmissionRingSize;
+  }
+
+  mSubmissionRing = mmap(nullptr, mSubmissionRingSize, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, mRingFileDescriptor, IORING_OFF_SQ_RING);
+  mCompletionRing = singleMapping
+                        ? mSubmissionRing
+                        : mmap(nullptr, mCompletionRingSize, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_POPULATE, mRingFileDescriptor, IORING_OFF_CQ_RING);
+
+  mSubmissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+  mSubmissionEntries = mmap(nullptr, mSubmissionEntriesSize, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, mRingFileDescriptor, IORING_OFF_SQES);
+
+  if (mSubmissionRing == MAP_FAILED || mCompletionRing == MAP_FAILED ||
+      mSubmissionEntries == MAP_FAILED) {
+    close(mRingFileDescriptor);
+    throw std::runtime_error("Failed to map the io_uring queues");
+  }
+
+  auto *submissionRing = static_cast<uint8_t *>(mSubmissionRing);
+  mSubmissionHead = reinterpret_cast<unsigned int *>(submissionRing + params.sq_off.head);
+  mSubmissionTail = reinterpret_cast<unsigned int *>(submissionRing + params.sq_off.tail);
+  mSubmissionMask = *reinterpret_cast<unsigned int *>(submissionRing + params.sq_off.ring_mask);
+  mSubmissionEntryCount = params.sq_entries;
+  mSubmissionArray = reinterpret_cast<unsigned int *>(submissionRing + params.sq_off.array);
+
+  auto *completionRing = static_cast<uint8_t *>(mCompletionRing);
+  mCompletionHead = reinterpret_cast<unsigned int *>(completionRing + params.cq_off.head);
+  mCompletionTail = reinterpret_cast<unsigned int *>(completionRing + params.cq_off.tail);
+  mCompletionMask = *reinterpret_cast<unsigned int *>(completionRing + params.cq_off.ring_mask);
+  mCompletionEntryCount = params.cq_entries;
+  mCompletions = completionRing + params.cq_off.cqes;
+}
+
+IoUringBackend::~IoUringBackend() {
+  // the kernel may still be writing into caller buffers
+  mQueued.clear();
+  std::vector<IOCompletion> ignored{};
+  while (mInFlight > 0) {
+    wait(ignored, mInFlight);
+  }
+
+  munmap(mSubmissionEntries, mSubmissionEntriesSize);
+  if (mCompletionRing != mSubmissionRing) {
+    munmap(mCompletionRing, mCompletionRingSize);
+  }
+  munmap(mSubmissionRing, mSubmissionRingSize);
+  close(mRingFileDescriptor);
+}
+
+void IoUringBackend::fillSubmissionQueue() {
+  unsigned int tail = *mSubmissionTail;
+  unsigned int const head = __atomic_load_n(mSubmissionHead, __ATOMIC_ACQUIRE);
+
+  // never put more requests in flight than the completion queue can hold
+  while (!mQueued.empty() && tail - head < mSubmissionEntryCount &&
+         mInFlight < mCompletionEntryCount) {
+    IORequest const &request = mQueued.front();
+    unsigned int const index = tail & mSubmissionMask;
+
+    io_uring_sqe &entry = static_cast<io_uring_sqe *>(mSubmissionEntries)[index];
+    std::memset(&entry, 0, sizeof(io_uring_sqe));
+    entry.fd = request.fileDescriptor;
+    entry.user_data = request.userData;
+
+    if (request.type == IORequest::Type::eSync) {
+      entry.opcode = IORING_OP_FSYNC;
+      entry.fsync_flags = IORING_FSYNC_DATASYNC;
+    } else {
+      entry.opcode = request.type == IORequest::Type::eRead ? IORING_OP_READ : IORING_OP_WRITE;
+      entry.off = request.offset;
+      entry.addr = reinterpret_cast<uint64_t>(request.data);
+      entry.len = request.size;
+    }
+
+    mSubmissionArray[index] = index;
+    tail++;
+    mInFlight++;
+    mQueued.pop_front();
+  }
+
+  __atomic_store_n(mSubmissionTail, tail, __ATOMIC_RELEASE);
+}
+
+unsigned int IoUringBackend::getUnsubmittedCount() const {
+  return *mSubmissionTail - __atomic_load_n(mSubmissionHead, __ATOMIC_ACQUIRE);
+}
+
+void IoUringBackend::enter(unsigned int const &toSubmit, unsigned int const &minComplete) {
+  if (toSubmit == 0 && minComplete == 0) {
+    return;
+  }
+
+  unsigned int const flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+  while (syscall(__NR_io_uring_enter, mRingFileDescriptor, toSubmit, minComplete, flags, nullptr,
+                 0) < 0) {
+    if (errno == EINTR) {
+      continue;
+    }
+    // the completion queue is full, reaping makes room
+    if (errno == EBUSY || errno == EAGAIN) {
+      return;
+    }
+    throw std::runtime_error("io_uring_enter failed: " + std::string{std::strerror(errno)});
+  }
+}
+
+void IoUringBackend::reap(std::vector<IOCompletion> &completions) {
+  unsigned int head = *mCompletionHead;
+  unsigned int const tail = __atomic_load_n(mCompletionTail, __ATOMIC_ACQUIRE);
+
+  while (head != tail) {
+    io_uring_cqe const &entry = static_cast<io_uring_cqe *>(mCompletions)[head & mCompletionMask];
+    completions.push_back(IOCompletion{entry.user_data, entry.res});
+    head++;
+    mInFlight--;
+  }
+
+  __atomic_store_n(mCompletionHead, head, __ATOMIC_RELEASE);
+}
+
+void IoUringBackend::submit(std::vector<IORequest> const &requests) {
+  mQueued.insert(mQueued.end(), requests.begin(), requests.end());
+
+  fillSubmissionQueue();
+  enter(getUnsubmittedCount(), 0);
+}
+
+void IoUringBackend::wait(std::vector<IOCompletion> &completions,
+                          std::size_t const &minCompletions) {
+  std::size_t const target = completions.size() + std::min(minCompletions, getPendingCount());
+
+  do {
+    reap(completions);
+    fillSubmissionQueue();
+
+    unsigned int const minComplete = completions.size() < target ? 1 : 0;
+    enter(getUnsubmittedCount(), minComplete);
+
+    reap(completions);
+  } while (completions.size() < target);
+}
+
+std::size_t IoUringBackend::getPendingCount() const { return mQueued.size() + mInFlight; }
+#else
+bool IoUringBackend::isSupported() { return false; }
+
+IoUringBackend::IoUringBackend() {
+  throw std::runtime_error("io_uring is not available on this platform");
+}
+
+IoUringBackend::~IoUringBackend() = default;
+
+void IoUringBackend::submit(std::vector<IORequest> const &) {}
+
+void IoUringBackend::wait(std::vector<IOCompletion> &, std::size_t const &) {}
+
+std::size_t IoUringBackend::getPendingCount() const { return 0; }
+#endif
+
+char const *IoUringBackend::getName() const { return "io_uring"; }
+} // namespace cbl
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <deque>
+
+#include "Core/Files/IO/IOBackend.hpp"
+
+namespace cbl {
+// Linux io_uring driven through raw system calls, a whole batch costs a single io_uring_enter
+struct IoUringBackend final : public IOBackend {
+private:
+  static constexpr unsigned int QueueDepth = 256;
+
+  int mRingFileDescriptor{-1};
+
+  void *mSubmissionRing{nullptr};
+  std::size_t mSubmissionRingSize{0};
+  void *mCompletionRing{nullptr};
+  std::size_t mCompletionRingSize{0};
+  void *mSubmissionEntries{nullptr};
+  std::size_t mSubmissionEntriesSize{0};
+
+  unsigned int *mSubmissionHead{nullptr};
+  unsigned int *mSubmissionTail{nullptr};
+  unsigned int mSubmissionMask{0};
+  unsigned int mSubmissionEntryCount{0};
+  unsigned int *mSubmissionArray{nullptr};
+
+  unsigned int *mCompletionHead{nullptr};
+  unsigned int *mCompletionTail{nullptr};
+  unsigned int mCompletionMask{0};
+  unsigned int mCompletionEntryCount{0};
+  void *mCompletions{nullptr};
+
+  // accepted requests waiting for room in the rings
+  std::deque<IORequest> mQueued;
+  std::size_t mInFlight{0};
+
+  void fillSubmissionQueue();
+  [[nodiscard]] unsigned int getUnsubmittedCount() const;
+  void enter(unsigned int const &toSubmit, unsigned int const &minComplete);
+  void reap(std::vector<IOCompletion> &completions);
+
+public:
+  // needs IORING_OP_READ and IORING_OP_WRITE, available since Linux 5.6
+  [[nodiscard]] static bool isSupported();
+
+  IoUringBackend();
+  // waits for every request the kernel still holds buffers of
+  ~IoUringBackend() override;
+
+  void submit(std::vector<IORequest> const &requests) override;
+  void wait(std::vector<IOCompletion> &completions, std::size_t const &minCompletions) override;
+  [[nodiscard]] std::size_t getPendingCount() const override;
+  [[nodiscard]] char const *getName() const override;
+};
+} // namespace cbl
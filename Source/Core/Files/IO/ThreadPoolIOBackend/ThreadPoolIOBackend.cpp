@@ -0,0 +1,56 @@
+#include "ThreadPoolIOBackend.hpp"
+
+#include <algorithm>
+
+namespace cbl {
+void ThreadPoolIOBackend::complete(IOCompletion const &completion) {
+  {
+    std::lock_guard<std::mutex> lock{mMutex};
+    mCompletions.push_back(completion);
+  }
+  mCompleted.notify_one();
+}
+
+void ThreadPoolIOBackend::submit(std::vector<IORequest> const &requests) {
+  {
+    std::lock_guard<std::mutex> lock{mMutex};
+    mPendingCount += requests.size();
+  }
+
+  for (IORequest const &request : requests) {
+    mPool.enqueue([this, request]() {
+      int64_t result = 0;
+      switch (request.type) {
+      case IORequest::Type::eRead:
+        result = readAt(request.fileDescriptor, request.data, request.size, request.offset);
+        break;
+      case IORequest::Type::eWrite:
+        result = writeAt(request.fileDescriptor, request.data, request.size, request.offset);
+        break;
+      case IORequest::Type::eSync:
+        result = syncFile(request.fileDescriptor);
+        break;
+      }
+      complete(IOCompletion{request.userData, result});
+    });
+  }
+}
+
+void ThreadPoolIOBackend::wait(std::vector<IOCompletion> &completions,
+                               std::size_t const &minCompletions) {
+  std::unique_lock<std::mutex> lock{mMutex};
+  std::size_t const available = std::min(minCompletions, mPendingCount);
+  mCompleted.wait(lock, [this, available]() { return mCompletions.size() >= available; });
+
+  mPendingCount -= mCompletions.size();
+  completions.insert(completions.end(), mCompletions.begin(), mCompletions.end());
+  mCompletions.clear();
+}
+
+std::size_t ThreadPoolIOBackend::getPendingCount() const {
+  std::lock_guard<std::mutex> lock{mMutex};
+  return mPendingCount;
+}
+
+char const *ThreadPoolIOBackend::getName() const { return "thread pool"; }
+} // namespace cbl
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <condition_variable>
+#include <mutex>
+
+#include "Core/Files/IO/IOBackend.hpp"
+#include "Core/Threading/ThreadPool/ThreadPool.hpp"
+
+namespace cbl {
+// blocking pread/pwrite calls spread over a small pool of threads
+struct ThreadPoolIOBackend final : public IOBackend {
+private:
+  static constexpr unsigned int ThreadCount = 4;
+
+  mutable std::mutex mMutex;
+  std::condition_variable mCompleted;
+  std::vector<IOCompletion> mCompletions;
+  std::size_t mPendingCount{0};
+
+  // declared last so the workers are joined before the state they report to is destroyed
+  ThreadPool mPool{ThreadCount};
+
+  void complete(IOCompletion const &completion);
+
+public:
+  ThreadPoolIOBackend() = default;
+  ~ThreadPoolIOBackend() override = default;
+
+  void submit(std::vector<IORequest> const &requests) override;
+  void wait(std::vector<IOCompletion> &completions, std::size_t const &minCompletions) override;
+  [[nodiscard]] std::size_t getPendingCount() const override;
+  [[nodiscard]] char const *getName() const override;
+};
+} // namespace cbl
@@ -0,0 +1,102 @@
+#include "MappedFile.hpp"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cbl {
+#ifdef _WIN32
+MappedFile::MappedFile(std::filesystem::path const &path) {
+  mFileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (mFileHandle == INVALID_HANDLE_VALUE) {
+    mFileHandle = nullptr;
+    throw std::runtime_error("Failed to open " + path.string());
+  }
+
+  LARGE_INTEGER fileSize{};
+  GetFileSizeEx(mFileHandle, &fileSize);
+  mSize = static_cast<std::size_t>(fileSize.QuadPart);
+
+  // empty files cannot be mapped
+  if (mSize == 0) {
+    return;
+  }
+
+  mMappingHandle = CreateFileMappingW(mFileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mMappingHandle == nullptr) {
+    CloseHandle(mFileHandle);
+    throw std::runtime_error("Failed to map " + path.string());
+  }
+
+  mData = static_cast<uint8_t const *>(MapViewOfFile(mMappingHandle, FILE_MAP_READ, 0, 0, 0));
+  if (mData == nullptr) {
+    CloseHandle(mMappingHandle);
+    CloseHandle(mFileHandle);
+    throw std::runtime_error("Failed to map " + path.string());
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (mData != nullptr) {
+    UnmapViewOfFile(mData);
+  }
+
+  if (mMappingHandle != nullptr) {
+    CloseHandle(mMappingHandle);
+  }
+
+  if (mFileHandle != nullptr) {
+    CloseHandle(mFileHandle);
+  }
+}
+#else
+MappedFile::MappedFile(std::filesystem::path const &path) {
+  mFileDescriptor = open(path.c_str(), O_RDONLY);
+  if (mFileDescriptor == -1) {
+    throw std::runtime_error("Failed to open " + path.string());
+  }
+
+  struct stat fileStatus {};
+  if (fstat(mFileDescriptor, &fileStatus) == -1) {
+    close(mFileDescriptor);
+    throw std::runtime_error("Failed to read the size of " + path.string());
+  }
+  mSize = static_cast<std::size_t>(fileStatus.st_size);
+
+  // empty files cannot be mapped
+  if (mSize == 0) {
+    return;
+  }
+
+  void *mapping = mmap(nullptr, mSize, PROT_READ, MAP_SHARED, mFileDescriptor, 0);
+  if (mapping == MAP_FAILED) {
+    close(mFileDescriptor);
+    throw std::runtime_error("Failed to map " + path.string());
+  }
+
+  mData = static_cast<uint8_t const *>(mapping);
+}
+
+MappedFile::~MappedFile() {
+  if (mData != nullptr) {
+    munmap(const_cast<uint8_t *>(mData), mSize);
+  }
+
+  close(mFileDescriptor);
+}
+#endif
+
+uint8_t const *MappedFile::data() const { return mData; }
+
+std::size_t MappedFile::size() const { return mSize; }
+} // namespace cbl
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace cbl {
+// read-only view of a whole file, backed by the page cache
+struct MappedFile {
+private:
+  uint8_t const *mData{nullptr};
+  std::size_t mSize{0};
+
+#ifdef _WIN32
+  void *mFileHandle{nullptr};
+  void *mMappingHandle{nullptr};
+#else
+  int mFileDescriptor{-1};
+#endif
+
+public:
+  MappedFile() = delete;
+  explicit MappedFile(std::filesystem::path const &path);
+  MappedFile(MappedFile const &) = delete;
+  ~MappedFile();
+
+  void operator=(MappedFile const &) = delete;
+
+  [[nodiscard]] uint8_t const *data() const;
+  [[nodiscard]] std::size_t size() const;
+};
+} // namespace cbl
@@ -1,46 +1,87 @@
 #include "Input.hpp"
 
-#include <algorithm>
 #include <stdexcept>
 
 namespace cbl {
-std::vector<SDL_Event> Input::mEvents{};
+Vector2<int> Input::mAccumulatedMouseMovement{0, 0};
+bool Input::mAccumulatedLeftClick{false};
+bool Input::mAccumulatedRightClick{false};
+InputTick Input::mTick{};
+InputBindings Input::mBindings{InputBindings::getDefaults()};
+InputRecording *Input::mRecording{nullptr};
+InputRecording const *Input::mPlayback{nullptr};
+std::size_t Input::mPlaybackTick{0};
 
-void Input::updateEvents(std::vector<SDL_Event> const &events) { mEvents = events; }
+void Input::updateEvents(FrameVector<SDL_Event> const &events) {
+  for (SDL_Event const &event : events) {
+    if (event.type == SDL_MOUSEMOTION) {
+      mAccumulatedMouseMovement += Vector2<int>{event.motion.xrel, event.motion.yrel};
+    } else if (event.type == SDL_MOUSEBUTTONDOWN) {
+      mAccumulatedLeftClick |= event.button.button == SDL_BUTTON_LEFT;
+      mAccumulatedRightClick |= event.button.button == SDL_BUTTON_RIGHT;
+    }
+  }
+}
+
+void Input::beginTick() {
+  if (mPlayback != nullptr) {
+    mTick = mPlaybackTick < mPlayback->ticks.size() ? mPlayback->ticks[mPlaybackTick++]
+                                                    : InputTick{};
+    mTick.actions = mBindings.resolve(mTick.keys);
+    return;
+  }
 
-bool Input::keyPressed(std::string const &keyName) {
-  Uint8 const *keyStates = SDL_GetKeyboardState(nullptr);
-  const SDL_Scancode scanCode = SDL_GetScancodeFromName(keyName.c_str());
+  mTick = InputTick{};
+  // like mouse movement, clicks only go to the first step that runs after them
+  mTick.mouseMovement = mAccumulatedMouseMovement;
+  mTick.leftClicked = mAccumulatedLeftClick;
+  mTick.rightClicked = mAccumulatedRightClick;
+  mAccumulatedMouseMovement = Vector2<int>{0, 0};
+  mAccumulatedLeftClick = false;
+  mAccumulatedRightClick = false;
 
-  if (scanCode == SDL_SCANCODE_UNKNOWN) {
-    throw std::runtime_error("Failed to parse key code");
+  int keyCount = 0;
+  Uint8 const *keyStates = SDL_GetKeyboardState(&keyCount);
+  for (int key = 0; key < keyCount && key < SDL_NUM_SCANCODES; key++) {
+    mTick.keys[static_cast<std::size_t>(key)] = keyStates[key] != 0;
   }
 
-  return keyStates[scanCode];
-}
+  mTick.actions = mBindings.resolve(mTick.keys);
 
-Vector2<int> Input::getMouseMovement() {
-  for (SDL_Event event : mEvents) {
-    if (event.type == SDL_MOUSEMOTION) {
-      return Vector2<int>{event.motion.xrel, event.motion.yrel};
-    }
+  if (mRecording != nullptr) {
+    mRecording->ticks.push_back(mTick);
   }
+}
+
+void Input::setBindings(InputBindings const &bindings) {
+  mBindings = bindings;
+  mTick.actions = mBindings.resolve(mTick.keys);
+}
 
-  return Vector2<int>{0, 0};
+bool Input::actionActive(InputAction const &action) {
+  return mTick.actions[static_cast<std::size_t>(action)];
 }
 
-bool Input::mouseLeftClicked() {
-  return std::any_of(mEvents.begin(), mEvents.end(), [](SDL_Event e) {
-    return e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_LEFT;
-  });
+bool Input::keyPressed(SDL_Scancode const &scancode) {
+  if (scancode < 0 || scancode >= SDL_NUM_SCANCODES) {
+    throw std::out_of_range("Invalid scancode");
+  }
+
+  return mTick.keys[static_cast<std::size_t>(scancode)];
 }
 
-bool Input::mouseRightClicked() {
-  return std::any_of(mEvents.begin(), mEvents.end(), [](SDL_Event e) {
-    return e.type == SDL_MOUSEBUTTONDOWN && e.button.button == SDL_BUTTON_RIGHT;
-  });
+Vector2<int> Input::getMouseMovement() { return mTick.mouseMovement; }
+
+Vector2<int> Input::consumeMouseMovement() {
+  Vector2<int> const movement = mTick.mouseMovement;
+  mTick.mouseMovement = Vector2<int>{0, 0};
+  return movement;
 }
 
+bool Input::mouseLeftClicked() { return mTick.leftClicked; }
+
+bool Input::mouseRightClicked() { return mTick.rightClicked; }
+
 void Input::grabCursor() {
   SDL_SetRelativeMouseMode(SDL_TRUE);
   SDL_CaptureMouse(SDL_TRUE);
@@ -51,4 +92,19 @@ void Input::releaseCursor() {
   SDL_CaptureMouse(SDL_FALSE);
 }
 
+void Input::startRecording(InputRecording &recording) { mRecording = &recording; }
+
+void Input::stopRecording() { mRecording = nullptr; }
+
+void Input::startPlayback(InputRecording const &recording) {
+  mPlayback = &recording;
+  mPlaybackTick = 0;
+}
+
+void Input::stopPlayback() { mPlayback = nullptr; }
+
+bool Input::isPlaybackFinished() {
+  return mPlayback == nullptr || mPlaybackTick >= mPlayback->ticks.size();
+}
+
 } // namespace cbl
@@ -1,32 +1,64 @@
 #pragma once
 
 #include <string>
-#include <vector>
 
 #include <SDL2/SDL.h>
 
+#include "Core/Input/InputRecording/InputRecording.hpp"
+#include "Core/Memory/FrameArena/FrameArena.hpp"
 #include "Graphics/Window/Window.hpp"
 #include "Math/Vector/Vector2/Vector2.hpp"
 
 namespace cbl {
+namespace gfx {
+struct Engine;
+}
+
 struct Input {
 private:
-  static std::vector<SDL_Event> mEvents;
+  static Vector2<int> mAccumulatedMouseMovement;
+  static bool mAccumulatedLeftClick;
+  static bool mAccumulatedRightClick;
+  // what the current simulation step sees, either live or played back
+  static InputTick mTick;
+  static InputBindings mBindings;
+  static InputRecording *mRecording;
+  static InputRecording const *mPlayback;
+  static std::size_t mPlaybackTick;
 
   Input() = default;
 
-  static void updateEvents(std::vector<SDL_Event> const &events);
+  // events pile up until the next simulation step takes them, so no step misses them and none
+  // sees them twice
+  static void updateEvents(FrameVector<SDL_Event> const &events);
+  // called before every simulation step
+  static void beginTick();
   friend struct gfx::Window;
+  friend struct gfx::Engine;
 
 public:
   Input(Input const &) = delete;
   void operator=(Input const &) = delete;
 
-  [[nodiscard]] static bool keyPressed(std::string const &keyName);
+  static void setBindings(InputBindings const &bindings);
+  [[nodiscard]] static bool actionActive(InputAction const &action);
+  [[nodiscard]] static bool keyPressed(SDL_Scancode const &scancode);
+  // mouse movement of the current simulation step, without consuming it
   [[nodiscard]] static Vector2<int> getMouseMovement();
+  // mouse movement of the current simulation step, zero after the first call
+  [[nodiscard]] static Vector2<int> consumeMouseMovement();
   [[nodiscard]] static bool mouseLeftClicked();
   [[nodiscard]] static bool mouseRightClicked();
   static void grabCursor();
   static void releaseCursor();
+
+  // appends the input of every following simulation step to recording
+  static void startRecording(InputRecording &recording);
+  static void stopRecording();
+  // simulation steps see the recorded input instead of the live one, then no input at all once
+  // the recording is over
+  static void startPlayback(InputRecording const &recording);
+  static void stopPlayback();
+  [[nodiscard]] static bool isPlaybackFinished();
 };
 } // namespace cbl
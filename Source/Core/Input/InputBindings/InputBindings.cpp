@@ -0,0 +1,53 @@
+#include "InputBindings.hpp"
+
+#include <stdexcept>
+
+namespace cbl {
+InputBindings InputBindings::getDefaults() {
+  InputBindings bindings{};
+  bindings.bind(InputAction::eMoveForward, SDL_SCANCODE_W);
+  bindings.bind(InputAction::eMoveBackward, SDL_SCANCODE_S);
+  bindings.bind(InputAction::eMoveLeft, SDL_SCANCODE_A);
+  bindings.bind(InputAction::eMoveRight, SDL_SCANCODE_D);
+  bindings.bind(InputAction::eMoveUp, SDL_SCANCODE_E);
+  bindings.bind(InputAction::eMoveDown, SDL_SCANCODE_Q);
+  bindings.bind(InputAction::eSprint, SDL_SCANCODE_LSHIFT);
+  bindings.bind(InputAction::eReleaseCursor, SDL_SCANCODE_ESCAPE);
+  return bindings;
+}
+
+SDL_Scancode InputBindings::getScancode(std::string const &keyName) {
+  SDL_Scancode const scancode = SDL_GetScancodeFromName(keyName.c_str());
+
+  if (scancode == SDL_SCANCODE_UNKNOWN) {
+    throw std::invalid_argument("Unknown key " + keyName);
+  }
+
+  return scancode;
+}
+
+void InputBindings::bind(InputAction const &action, SDL_Scancode const &scancode) {
+  if (action == InputAction::eCount || scancode <= SDL_SCANCODE_UNKNOWN ||
+      scancode >= SDL_NUM_SCANCODES) {
+    throw std::out_of_range("Invalid input binding");
+  }
+
+  mKeys[static_cast<std::size_t>(action)].set(static_cast<std::size_t>(scancode));
+}
+
+void InputBindings::bind(InputAction const &action, std::string const &keyName) {
+  bind(action, getScancode(keyName));
+}
+
+void InputBindings::unbind(InputAction const &action) {
+  mKeys.at(static_cast<std::size_t>(action)).reset();
+}
+
+InputBindings::Actions InputBindings::resolve(Keys const &keys) const {
+  Actions actions{};
+  for (std::size_t action = 0; action < ActionCount; action++) {
+    actions[action] = (mKeys[action] & keys).any();
+  }
+  return actions;
+}
+} // namespace cbl
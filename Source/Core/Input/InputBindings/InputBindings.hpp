@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <string>
+
+#include <SDL2/SDL.h>
+
+namespace cbl {
+enum class InputAction : std::size_t {
+  eMoveForward,
+  eMoveBackward,
+  eMoveLeft,
+  eMoveRight,
+  eMoveUp,
+  eMoveDown,
+  eSprint,
+  eReleaseCursor,
+  eCount
+};
+
+// keys bound to every action, resolved to scancodes when bound so that polling an action is a
+// bitset lookup
+struct InputBindings {
+public:
+  static constexpr std::size_t ActionCount = static_cast<std::size_t>(InputAction::eCount);
+  using Keys = std::bitset<SDL_NUM_SCANCODES>;
+  using Actions = std::bitset<ActionCount>;
+
+private:
+  std::array<Keys, ActionCount> mKeys{};
+
+public:
+  // WASD to move, E and Q up and down, left shift to sprint and escape to release the cursor
+  [[nodiscard]] static InputBindings getDefaults();
+  // key names as SDL knows them, such as "w" or "Left Shift"
+  [[nodiscard]] static SDL_Scancode getScancode(std::string const &keyName);
+
+  void bind(InputAction const &action, SDL_Scancode const &scancode);
+  void bind(InputAction const &action, std::string const &keyName);
+  void unbind(InputAction const &action);
+
+  // actions with at least one of their keys held
+  [[nodiscard]] Actions resolve(Keys const &keys) const;
+};
+} // namespace cbl
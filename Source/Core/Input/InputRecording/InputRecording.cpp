@@ -0,0 +1,88 @@
+#include "InputRecording.hpp"
+
+#include <array>
+#include <fstream>
+#include <stdexcept>
+
+namespace cbl {
+namespace {
+constexpr std::size_t KeyBytes = (SDL_NUM_SCANCODES + 7) / 8;
+
+template <typename T> void writeValue(std::ofstream &file, T const &value) {
+  file.write(reinterpret_cast<char const *>(&value), sizeof(T));
+}
+
+template <typename T> [[nodiscard]] T readValue(std::ifstream &file) {
+  T value{};
+  file.read(reinterpret_cast<char *>(&value), sizeof(T));
+  return value;
+}
+} // namespace
+
+InputRecording InputRecording::load(std::filesystem::path const &path) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open input recording " + path.string());
+  }
+
+  if (readValue<uint32_t>(file) != Magic || readValue<uint32_t>(file) != Version) {
+    throw std::runtime_error(path.string() + " is not a supported input recording");
+  }
+
+  InputRecording recording{};
+  recording.seed = readValue<uint32_t>(file);
+  recording.ticks.resize(readValue<uint32_t>(file));
+
+  std::array<uint8_t, KeyBytes> keys{};
+  for (InputTick &tick : recording.ticks) {
+    tick.mouseMovement.x = readValue<int32_t>(file);
+    tick.mouseMovement.y = readValue<int32_t>(file);
+
+    uint8_t const buttons = readValue<uint8_t>(file);
+    tick.leftClicked = (buttons & 1u) != 0;
+    tick.rightClicked = (buttons & 2u) != 0;
+
+    file.read(reinterpret_cast<char *>(keys.data()), keys.size());
+    for (std::size_t key = 0; key < SDL_NUM_SCANCODES; key++) {
+      tick.keys[key] = (keys[key / 8] >> (key % 8)) & 1u;
+    }
+  }
+
+  if (!file) {
+    throw std::runtime_error("Input recording " + path.string() + " is truncated");
+  }
+
+  return recording;
+}
+
+void InputRecording::save(std::filesystem::path const &path) const {
+  std::ofstream file{path, std::ios::binary};
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open input recording " + path.string());
+  }
+
+  writeValue(file, Magic);
+  writeValue(file, Version);
+  writeValue(file, seed);
+  writeValue(file, static_cast<uint32_t>(ticks.size()));
+
+  for (InputTick const &tick : ticks) {
+    writeValue(file, static_cast<int32_t>(tick.mouseMovement.x));
+    writeValue(file, static_cast<int32_t>(tick.mouseMovement.y));
+    writeValue(file, static_cast<uint8_t>((tick.leftClicked ? 1u : 0u) |
+                                          (tick.rightClicked ? 2u : 0u)));
+
+    std::array<uint8_t, KeyBytes> keys{};
+    for (std::size_t key = 0; key < SDL_NUM_SCANCODES; key++) {
+      if (tick.keys[key]) {
+        keys[key / 8] |= static_cast<uint8_t>(1u << (key % 8));
+      }
+    }
+    file.write(reinterpret_cast<char const *>(keys.data()), keys.size());
+  }
+
+  if (!file) {
+    throw std::runtime_error("Failed to write input recording " + path.string());
+  }
+}
+} // namespace cbl
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <SDL2/SDL.h>
+
+#include "Core/Input/InputBindings/InputBindings.hpp"
+#include "Math/Vector/Vector2/Vector2.hpp"
+
+namespace cbl {
+// input seen by one simulation step
+struct InputTick {
+  // every motion event since the previous step
+  Vector2<int> mouseMovement{0, 0};
+  InputBindings::Keys keys{};
+  bool leftClicked = false;
+  bool rightClicked = false;
+  // resolved from keys with the current bindings, so recordings only store the keys
+  InputBindings::Actions actions{};
+};
+
+// input of every simulation step of a session, replaying it on the same world seed gives the
+// same camera path
+struct InputRecording {
+private:
+  static constexpr uint32_t Magic = 0x52494243; // "CBIR"
+  static constexpr uint32_t Version = 1;
+
+public:
+  uint32_t seed = 0;
+  std::vector<InputTick> ticks{};
+
+  [[nodiscard]] static InputRecording load(std::filesystem::path const &path);
+  void save(std::filesystem::path const &path) const;
+};
+} // namespace cbl
@@ -0,0 +1,171 @@
+#include "AllocationTracker.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace cbl {
+std::array<AllocationTracker::Counters, AllocationFrame::MaxSubsystems>
+    AllocationTracker::mCounters{};
+std::atomic<uint64_t> AllocationTracker::mFrees{0};
+thread_local char const *AllocationTracker::mSubsystem{nullptr};
+AllocationFrame AllocationTracker::mLastFrame{};
+
+std::size_t AllocationTracker::getCountersIndex(char const *subsystem) {
+  // slot 0 holds the allocations made outside of any scope, and those of subsystems that no
+  // longer fit in the table
+  if (subsystem == nullptr) {
+    return 0;
+  }
+
+  for (std::size_t i = 1; i < mCounters.size(); i++) {
+    char const *name = mCounters[i].subsystem.load(std::memory_order_acquire);
+
+    if (name == nullptr) {
+      if (mCounters[i].subsystem.compare_exchange_strong(name, subsystem,
+                                                         std::memory_order_acq_rel)) {
+        return i;
+      }
+      // another thread claimed the slot, name now holds its subsystem
+    }
+
+    if (name == subsystem || std::strcmp(name, subsystem) == 0) {
+      return i;
+    }
+  }
+
+  return 0;
+}
+
+void AllocationTracker::recordAllocation(std::size_t const &size) {
+  Counters &counters = mCounters[getCountersIndex(mSubsystem)];
+  counters.allocations.fetch_add(1, std::memory_order_relaxed);
+  counters.bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void AllocationTracker::recordFree() { mFrees.fetch_add(1, std::memory_order_relaxed); }
+
+char const *AllocationTracker::setSubsystem(char const *subsystem) {
+  char const *previous = mSubsystem;
+  mSubsystem = subsystem;
+  return previous;
+}
+
+void AllocationTracker::endFrame() {
+  AllocationFrame frame{};
+  frame.frees = mFrees.exchange(0, std::memory_order_relaxed);
+
+  for (std::size_t i = 0; i < mCounters.size(); i++) {
+    uint64_t const allocations = mCounters[i].allocations.exchange(0, std::memory_order_relaxed);
+    uint64_t const bytes = mCounters[i].bytes.exchange(0, std::memory_order_relaxed);
+
+    frame.allocations += allocations;
+    frame.bytes += bytes;
+
+    if (allocations > 0) {
+      frame.subsystems[frame.subsystemCount++] = AllocationStats{
+          i == 0 ? nullptr : mCounters[i].subsystem.load(std::memory_order_acquire), allocations,
+          bytes};
+    }
+  }
+
+  mLastFrame = frame;
+}
+
+AllocationFrame const &AllocationTracker::getLastFrame() { return mLastFrame; }
+
+AllocationScope::AllocationScope(char const *subsystem)
+    : mPrevious{AllocationTracker::setSubsystem(subsystem)} {}
+
+AllocationScope::~AllocationScope() { AllocationTracker::setSubsystem(mPrevious); }
+} // namespace cbl
+
+#ifdef CBL_ALLOCATION_TRACKING
+// replaces the global allocation functions, which the linker picks over the standard library ones
+namespace {
+[[nodiscard]] void *allocate(std::size_t size) {
+  cbl::AllocationTracker::recordAllocation(size);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+[[nodiscard]] void *allocateAligned(std::size_t size, std::align_val_t alignment) {
+  cbl::AllocationTracker::recordAllocation(size);
+  auto const bytes = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+  return _aligned_malloc(size == 0 ? 1 : size, bytes);
+#else
+  // aligned_alloc wants a size that is a multiple of the alignment
+  return std::aligned_alloc(bytes, (std::max<std::size_t>(size, 1) + bytes - 1) / bytes * bytes);
+#endif
+}
+
+void release(void *pointer) {
+  if (pointer != nullptr) {
+    cbl::AllocationTracker::recordFree();
+    std::free(pointer);
+  }
+}
+
+void releaseAligned(void *pointer) {
+  if (pointer != nullptr) {
+    cbl::AllocationTracker::recordFree();
+#ifdef _WIN32
+    _aligned_free(pointer);
+#else
+    std::free(pointer);
+#endif
+  }
+}
+
+[[nodiscard]] void *throwIfNull(void *pointer) {
+  if (pointer == nullptr) {
+    throw std::bad_alloc{};
+  }
+  return pointer;
+}
+} // namespace
+
+void *operator new(std::size_t size) { return throwIfNull(allocate(size)); }
+void *operator new[](std::size_t size) { return throwIfNull(allocate(size)); }
+void *operator new(std::size_t size, std::nothrow_t const &) noexcept { return allocate(size); }
+void *operator new[](std::size_t size, std::nothrow_t const &) noexcept { return allocate(size); }
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  return throwIfNull(allocateAligned(size, alignment));
+}
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  return throwIfNull(allocateAligned(size, alignment));
+}
+void *operator new(std::size_t size, std::align_val_t alignment, std::nothrow_t const &) noexcept {
+  return allocateAligned(size, alignment);
+}
+void *operator new[](std::size_t size, std::align_val_t alignment,
+                     std::nothrow_t const &) noexcept {
+  return allocateAligned(size, alignment);
+}
+
+void operator delete(void *pointer) noexcept { release(pointer); }
+void operator delete[](void *pointer) noexcept { release(pointer); }
+void operator delete(void *pointer, std::size_t) noexcept { release(pointer); }
+void operator delete[](void *pointer, std::size_t) noexcept { release(pointer); }
+void operator delete(void *pointer, std::nothrow_t const &) noexcept { release(pointer); }
+void operator delete[](void *pointer, std::nothrow_t const &) noexcept { release(pointer); }
+void operator delete(void *pointer, std::align_val_t) noexcept { releaseAligned(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { releaseAligned(pointer); }
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept {
+  releaseAligned(pointer);
+}
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept {
+  releaseAligned(pointer);
+}
+void operator delete(void *pointer, std::align_val_t, std::nothrow_t const &) noexcept {
+  releaseAligned(pointer);
+}
+void operator delete[](void *pointer, std::align_val_t, std::nothrow_t const &) noexcept {
+  releaseAligned(pointer);
+}
+#endif
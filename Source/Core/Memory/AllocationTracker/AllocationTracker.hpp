@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace cbl {
+struct AllocationStats {
+  // nullptr for allocations made outside of any allocation scope
+  char const *subsystem = nullptr;
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+};
+
+struct AllocationFrame {
+  static constexpr std::size_t MaxSubsystems = 32;
+
+  std::array<AllocationStats, MaxSubsystems> subsystems{};
+  std::size_t subsystemCount = 0;
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+  uint64_t frees = 0;
+};
+
+// counts every heap allocation made through operator new, on all threads, grouped by the
+// allocation scope active on the allocating thread
+struct AllocationTracker {
+private:
+  struct Counters {
+    std::atomic<char const *> subsystem;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> bytes;
+  };
+
+  // filled from operator new, so nothing here may allocate
+  static std::array<Counters, AllocationFrame::MaxSubsystems> mCounters;
+  static std::atomic<uint64_t> mFrees;
+  static thread_local char const *mSubsystem;
+  static AllocationFrame mLastFrame;
+
+  [[nodiscard]] static std::size_t getCountersIndex(char const *subsystem);
+
+public:
+#ifdef CBL_ALLOCATION_TRACKING
+  static constexpr bool Enabled = true;
+#else
+  static constexpr bool Enabled = false;
+#endif
+
+  AllocationTracker() = delete;
+  AllocationTracker(AllocationTracker const &) = delete;
+  ~AllocationTracker() = delete;
+
+  static void recordAllocation(std::size_t const &size);
+  static void recordFree();
+
+  // allocations of the calling thread are counted for subsystem, returns the previous one
+  static char const *setSubsystem(char const *subsystem);
+
+  // closes the current frame, called once per frame by the main thread
+  static void endFrame();
+  // main thread only, valid until the next endFrame
+  [[nodiscard]] static AllocationFrame const &getLastFrame();
+};
+
+struct AllocationScope {
+private:
+  char const *mPrevious;
+
+public:
+  explicit AllocationScope(char const *subsystem);
+  AllocationScope(AllocationScope const &) = delete;
+  ~AllocationScope();
+
+  void operator=(AllocationScope const &) = delete;
+};
+} // namespace cbl
+
+#ifdef CBL_ALLOCATION_TRACKING
+#define CBL_ALLOCATION_CONCAT_INNER(a, b) a##b
+#define CBL_ALLOCATION_CONCAT(a, b) CBL_ALLOCATION_CONCAT_INNER(a, b)
+#define CBL_ALLOCATION_SCOPE(subsystem)                                                            \
+  ::cbl::AllocationScope CBL_ALLOCATION_CONCAT(allocationScope, __LINE__) { subsystem }
+#else
+#define CBL_ALLOCATION_SCOPE(subsystem) ((void)0)
+#endif
@@ -0,0 +1,54 @@
+#include "FrameArena.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+
+namespace cbl {
+namespace {
+[[nodiscard]] std::size_t alignUp(std::size_t const &value, std::size_t const &alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+} // namespace
+
+FrameArena::FrameArena(std::size_t const &capacity)
+    : mBuffer{std::make_unique<std::byte[]>(capacity)}, mCapacity{capacity} {}
+
+void *FrameArena::allocate(std::size_t const &size, std::size_t const &alignment) {
+  if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+    throw std::invalid_argument("Frame arena alignments must be powers of two");
+  }
+
+  // the buffer itself is only aligned for fundamental types, so align the address
+  auto const base = reinterpret_cast<std::uintptr_t>(mBuffer.get());
+  std::size_t const offset = alignUp(base + mOffset, alignment) - base;
+
+  if (offset + size <= mCapacity) {
+    mOffset = offset + size;
+    return mBuffer.get() + offset;
+  }
+
+  std::size_t const blockSize = size + alignment;
+  mOverflow.push_back(std::make_unique<std::byte[]>(blockSize));
+  mOverflowBytes += blockSize;
+
+  auto const blockBase = reinterpret_cast<std::uintptr_t>(mOverflow.back().get());
+  return mOverflow.back().get() + (alignUp(blockBase, alignment) - blockBase);
+}
+
+void FrameArena::reset() {
+  if (!mOverflow.empty()) {
+    // grows once so the next frames of the same size fit in the buffer
+    mCapacity = std::max(mCapacity * 2, mOffset + mOverflowBytes);
+    mBuffer = std::make_unique<std::byte[]>(mCapacity);
+    mOverflow.clear();
+    mOverflowBytes = 0;
+  }
+
+  mOffset = 0;
+}
+
+std::size_t FrameArena::getCapacity() const { return mCapacity; }
+
+std::size_t FrameArena::getUsedBytes() const { return mOffset + mOverflowBytes; }
+} // namespace cbl
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace cbl {
+// linear allocator for data that only lives until the end of the frame, used by a single thread
+// memory is kept between frames, so once the arena has grown to what a frame needs it no longer
+// touches the heap
+struct FrameArena {
+private:
+  std::unique_ptr<std::byte[]> mBuffer;
+  std::size_t mCapacity;
+  std::size_t mOffset{0};
+  // heap blocks for what did not fit in the buffer, folded into it on the next reset
+  std::vector<std::unique_ptr<std::byte[]>> mOverflow;
+  std::size_t mOverflowBytes{0};
+
+public:
+  static constexpr std::size_t DefaultCapacity = 256 * 1024;
+
+  explicit FrameArena(std::size_t const &capacity = DefaultCapacity);
+  FrameArena(FrameArena const &) = delete;
+  ~FrameArena() = default;
+
+  void operator=(FrameArena const &) = delete;
+
+  [[nodiscard]] void *allocate(std::size_t const &size, std::size_t const &alignment);
+  // everything allocated since the last reset becomes invalid
+  void reset();
+
+  [[nodiscard]] std::size_t getCapacity() const;
+  [[nodiscard]] std::size_t getUsedBytes() const;
+};
+
+// standard allocator over a frame arena, deallocation is a no-op until the arena is reset
+template <typename T> struct FrameAllocator {
+  using value_type = T;
+
+  FrameArena *arena;
+
+  explicit FrameAllocator(FrameArena &frameArena) noexcept : arena{&frameArena} {}
+  template <typename U>
+  FrameAllocator(FrameAllocator<U> const &other) noexcept : arena{other.arena} {}
+
+  [[nodiscard]] T *allocate(std::size_t count) {
+    return static_cast<T *>(arena->allocate(count * sizeof(T), alignof(T)));
+  }
+  void deallocate(T *, std::size_t) noexcept {}
+
+  template <typename U> bool operator==(FrameAllocator<U> const &other) const {
+    return arena == other.arena;
+  }
+  template <typename U> bool operator!=(FrameAllocator<U> const &other) const {
+    return arena != other.arena;
+  }
+};
+
+template <typename T> using FrameVector = std::vector<T, FrameAllocator<T>>;
+} // namespace cbl
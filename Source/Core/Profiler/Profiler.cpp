@@ -0,0 +1,143 @@
+#include "Profiler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+
+namespace cbl {
+
+std::mutex Profiler::mMutex{};
+std::vector<ProfileEvent> Profiler::mEvents{};
+std::size_t Profiler::mNextEvent = 0;
+std::map<uint32_t, char const *> Profiler::mThreadNames{{GpuThreadId, "GPU"}};
+
+namespace {
+void writeJsonString(std::ofstream &file, char const *text) {
+  file << '"';
+  for (char const *c = text; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      file << '\\';
+    }
+    file << *c;
+  }
+  file << '"';
+}
+} // namespace
+
+uint64_t Profiler::nowNs() {
+  static auto const epoch = std::chrono::steady_clock::now();
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - epoch)
+                                   .count());
+}
+
+uint32_t Profiler::currentThreadId() {
+  static std::atomic<uint32_t> nextThreadId{GpuThreadId + 1};
+  thread_local uint32_t const threadId = nextThreadId++;
+  return threadId;
+}
+
+void Profiler::record(ProfileEvent const &event) {
+  std::lock_guard<std::mutex> lock{mMutex};
+
+  if (mEvents.size() < MaxEvents) {
+    mEvents.push_back(event);
+  } else {
+    mEvents[mNextEvent] = event;
+  }
+  mNextEvent = (mNextEvent + 1) % MaxEvents;
+}
+
+void Profiler::setThreadName(char const *name) {
+  std::lock_guard<std::mutex> lock{mMutex};
+  mThreadNames[currentThreadId()] = name;
+}
+
+void Profiler::recordCpu(char const *name, uint64_t const &startNs, uint64_t const &endNs) {
+  record(ProfileEvent{name, startNs, endNs - startNs, currentThreadId()});
+}
+
+void Profiler::recordGpu(char const *name, uint64_t const &startNs, uint64_t const &durationNs) {
+  record(ProfileEvent{name, startNs, durationNs, GpuThreadId});
+}
+
+template <typename Events> void Profiler::copyEvents(Events &events) {
+  events.reserve(mEvents.size());
+
+  if (mEvents.size() < MaxEvents) {
+    events.insert(events.end(), mEvents.begin(), mEvents.end());
+  } else {
+    events.insert(events.end(), mEvents.begin() + mNextEvent, mEvents.end());
+    events.insert(events.end(), mEvents.begin(), mEvents.begin() + mNextEvent);
+  }
+}
+
+std::vector<ProfileEvent> Profiler::getEvents() {
+  std::lock_guard<std::mutex> lock{mMutex};
+
+  std::vector<ProfileEvent> events{};
+  copyEvents(events);
+  return events;
+}
+
+FrameVector<ProfileEvent> Profiler::getEvents(FrameArena &arena) {
+  std::lock_guard<std::mutex> lock{mMutex};
+
+  FrameVector<ProfileEvent> events{FrameAllocator<ProfileEvent>{arena}};
+  copyEvents(events);
+  return events;
+}
+
+std::map<uint32_t, char const *> Profiler::getThreadNames() {
+  std::lock_guard<std::mutex> lock{mMutex};
+  return mThreadNames;
+}
+
+char const *Profiler::getThreadName(uint32_t const &threadId) {
+  std::lock_guard<std::mutex> lock{mMutex};
+
+  auto const threadName = mThreadNames.find(threadId);
+  return threadName == mThreadNames.end() ? nullptr : threadName->second;
+}
+
+void Profiler::writeChromeTrace(std::filesystem::path const &path) {
+  std::vector<ProfileEvent> const events = getEvents();
+  std::map<uint32_t, char const *> const threadNames = getThreadNames();
+
+  std::ofstream file{path};
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open trace file " + path.string());
+  }
+
+  file << "{\"traceEvents\":[";
+  bool first = true;
+
+  for (auto const &[threadId, threadName] : threadNames) {
+    file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+         << threadId << ",\"args\":{\"name\":";
+    writeJsonString(file, threadName);
+    file << "}}";
+    first = false;
+  }
+
+  // timestamps and durations are in microseconds
+  file << std::fixed << std::setprecision(3);
+  for (ProfileEvent const &event : events) {
+    file << (first ? "" : ",") << "\n{\"name\":";
+    writeJsonString(file, event.name);
+    file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId
+         << ",\"ts\":" << static_cast<double>(event.startNs) / 1000.0
+         << ",\"dur\":" << static_cast<double>(event.durationNs) / 1000.0 << "}";
+    first = false;
+  }
+
+  file << "\n]}\n";
+}
+
+ProfileScope::ProfileScope(char const *name) : mName{name}, mStartNs{Profiler::nowNs()} {}
+
+ProfileScope::~ProfileScope() { Profiler::recordCpu(mName, mStartNs, Profiler::nowNs()); }
+} // namespace cbl
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "Core/Memory/FrameArena/FrameArena.hpp"
+
+namespace cbl {
+struct ProfileEvent {
+  char const *name;
+  uint64_t startNs;
+  uint64_t durationNs;
+  uint32_t threadId;
+};
+
+struct Profiler {
+private:
+  // the oldest events are overwritten once the buffer is full
+  static constexpr std::size_t MaxEvents = 1 << 14;
+
+  static std::mutex mMutex;
+  static std::vector<ProfileEvent> mEvents;
+  static std::size_t mNextEvent;
+  static std::map<uint32_t, char const *> mThreadNames;
+
+  static void record(ProfileEvent const &event);
+  // appends the recorded events oldest first, with the mutex held
+  template <typename Events> static void copyEvents(Events &events);
+  [[nodiscard]] static uint32_t currentThreadId();
+
+public:
+#ifdef CBL_PROFILING
+  static constexpr bool Enabled = true;
+#else
+  static constexpr bool Enabled = false;
+#endif
+
+  // GPU work is shown as its own track in traces
+  static constexpr uint32_t GpuThreadId = 0;
+
+  Profiler() = delete;
+  Profiler(Profiler const &) = delete;
+  ~Profiler() = delete;
+
+  [[nodiscard]] static uint64_t nowNs();
+
+  static void setThreadName(char const *name);
+  static void recordCpu(char const *name, uint64_t const &startNs, uint64_t const &endNs);
+  static void recordGpu(char const *name, uint64_t const &startNs, uint64_t const &durationNs);
+
+  // recorded events, oldest first
+  [[nodiscard]] static std::vector<ProfileEvent> getEvents();
+  // same as getEvents, without touching the heap when drawn every frame
+  [[nodiscard]] static FrameVector<ProfileEvent> getEvents(FrameArena &arena);
+  [[nodiscard]] static std::map<uint32_t, char const *> getThreadNames();
+  // nullptr for threads without a name
+  [[nodiscard]] static char const *getThreadName(uint32_t const &threadId);
+  // writes every recorded event in the Chrome trace event format (chrome://tracing, Perfetto)
+  static void writeChromeTrace(std::filesystem::path const &path);
+};
+
+struct ProfileScope {
+private:
+  char const *mName;
+  uint64_t mStartNs;
+
+public:
+  explicit ProfileScope(char const *name);
+  ProfileScope(ProfileScope const &) = delete;
+  ~ProfileScope();
+
+  void operator=(ProfileScope const &) = delete;
+};
+} // namespace cbl
+
+#ifdef CBL_PROFILING
+#define CBL_PROFILE_CONCAT_INNER(a, b) a##b
+#define CBL_PROFILE_CONCAT(a, b) CBL_PROFILE_CONCAT_INNER(a, b)
+#define CBL_PROFILE_SCOPE(name) ::cbl::ProfileScope CBL_PROFILE_CONCAT(profileScope, __LINE__){name}
+#else
+#define CBL_PROFILE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace cbl {
+// Bounded lock-free queue between exactly one producer and one consumer thread
+template <typename T, std::size_t Capacity> struct SPSCQueue {
+private:
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "SPSCQueue capacity must be a power of two");
+  static constexpr std::size_t IndexMask = Capacity - 1;
+
+  std::array<T, Capacity> mItems{};
+  alignas(64) std::atomic<std::size_t> mHead{0}; // next item to pop, written by the consumer
+  alignas(64) std::atomic<std::size_t> mTail{0}; // next free slot, written by the producer
+
+public:
+  SPSCQueue() = default;
+  SPSCQueue(SPSCQueue const &) = delete;
+
+  void operator=(SPSCQueue const &) = delete;
+
+  // returns false without moving from item when the queue is full
+  [[nodiscard]] bool tryPush(T &&item);
+  [[nodiscard]] bool tryPop(T &item);
+};
+
+template <typename T, std::size_t Capacity> bool SPSCQueue<T, Capacity>::tryPush(T &&item) {
+  std::size_t const tail = mTail.load(std::memory_order_relaxed);
+  if (tail - mHead.load(std::memory_order_acquire) == Capacity) {
+    return false;
+  }
+
+  mItems[tail & IndexMask] = std::move(item);
+  mTail.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T, std::size_t Capacity> bool SPSCQueue<T, Capacity>::tryPop(T &item) {
+  std::size_t const head = mHead.load(std::memory_order_relaxed);
+  if (head == mTail.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  item = std::move(mItems[head & IndexMask]);
+  mHead.store(head + 1, std::memory_order_release);
+  return true;
+}
+} // namespace cbl
@@ -0,0 +1,60 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace cbl {
+unsigned int ThreadPool::getDefaultThreadCount() {
+  // hardware_concurrency may report 0 when unknown
+  return std::max(2u, std::thread::hardware_concurrency()) - 1;
+}
+
+ThreadPool::ThreadPool(unsigned int const &threadCount) {
+  mWorkers.reserve(std::max(1u, threadCount));
+
+  for (unsigned int i = 0; i < std::max(1u, threadCount); i++) {
+    mWorkers.emplace_back(&ThreadPool::workerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock{mMutex};
+    mStopping = true;
+  }
+  mJobAvailable.notify_all();
+
+  for (std::thread &worker : mWorkers) {
+    worker.join();
+  }
+}
+
+void ThreadPool::workerLoop() {
+  while (true) {
+    std::function<void()> job;
+
+    {
+      std::unique_lock<std::mutex> lock{mMutex};
+      mJobAvailable.wait(lock, [this]() { return mStopping || !mJobs.empty(); });
+
+      if (mJobs.empty()) {
+        return;
+      }
+
+      job = std::move(mJobs.front());
+      mJobs.pop_front();
+    }
+
+    job();
+  }
+}
+
+void ThreadPool::enqueue(std::function<void()> job) {
+  {
+    std::lock_guard<std::mutex> lock{mMutex};
+    mJobs.push_back(std::move(job));
+  }
+  mJobAvailable.notify_one();
+}
+
+std::size_t ThreadPool::getThreadCount() const { return mWorkers.size(); }
+} // namespace cbl
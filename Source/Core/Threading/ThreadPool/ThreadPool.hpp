@@ -0,0 +1,52 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace cbl {
+// fixed set of worker threads running jobs in submission order
+struct ThreadPool {
+private:
+  std::vector<std::thread> mWorkers;
+  std::deque<std::function<void()>> mJobs;
+  std::mutex mMutex;
+  std::condition_variable mJobAvailable;
+  bool mStopping{false};
+
+  void workerLoop();
+
+public:
+  // one thread less than the hardware offers, the main thread already has a core
+  [[nodiscard]] static unsigned int getDefaultThreadCount();
+
+  explicit ThreadPool(unsigned int const &threadCount = getDefaultThreadCount());
+  ThreadPool(ThreadPool const &) = delete;
+  // queued jobs are finished before the workers exit
+  ~ThreadPool();
+
+  void operator=(ThreadPool const &) = delete;
+
+  void enqueue(std::function<void()> job);
+
+  template <typename Job>
+  [[nodiscard]] std::future<std::invoke_result_t<std::decay_t<Job>>> submit(Job &&job) {
+    using Result = std::invoke_result_t<std::decay_t<Job>>;
+
+    // packaged_task is move only and std::function needs a copyable callable
+    auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Job>(job));
+    std::future<Result> future = task->get_future();
+    enqueue([task]() { (*task)(); });
+
+    return future;
+  }
+
+  [[nodiscard]] std::size_t getThreadCount() const;
+};
+} // namespace cbl
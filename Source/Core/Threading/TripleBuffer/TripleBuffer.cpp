@@ -0,0 +1 @@
+#include "TripleBuffer.hpp"
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace cbl {
+// Lock-free handoff of the latest value between one producer and one consumer thread.
+// The producer never waits for the consumer, values that are never consumed are overwritten.
+// The consumer can sleep until a value is published, the producer only takes a lock to wake it
+// while it sleeps.
+template <typename T> struct TripleBuffer {
+private:
+  static constexpr uint8_t IndexMask = 0b011;
+  static constexpr uint8_t DirtyBit = 0b100;
+
+  std::array<T, 3> mBuffers{};
+  std::atomic<uint8_t> mMiddle{1};
+  uint8_t mBack = 0;  // producer only
+  uint8_t mFront = 2; // consumer only
+
+  // only used while the consumer sleeps, the buffers are swapped through mMiddle
+  std::atomic<bool> mConsumerWaiting{false};
+  std::mutex mWaitMutex;
+  std::condition_variable mPublished;
+  bool mClosed = false;
+
+public:
+  TripleBuffer() = default;
+  TripleBuffer(TripleBuffer const &) = delete;
+
+  void operator=(TripleBuffer const &) = delete;
+
+  // producer side
+  [[nodiscard]] T &back();
+  void publish();
+
+  // consumer side, returns false if nothing was published since the last call
+  [[nodiscard]] bool consume();
+  [[nodiscard]] T &front();
+  // blocks until a value is published, returns false once the buffer is closed
+  [[nodiscard]] bool waitForPublish();
+
+  // wakes the consumer and stops it from waiting until the buffer is opened again
+  void close();
+  void open();
+};
+
+template <typename T> T &TripleBuffer<T>::back() { return mBuffers[mBack]; }
+
+template <typename T> void TripleBuffer<T>::publish() {
+  // sequentially consistent, so either this sees the consumer waiting or the consumer sees the
+  // value before it sleeps
+  uint8_t const previousMiddle = mMiddle.exchange(mBack | DirtyBit, std::memory_order_seq_cst);
+  mBack = previousMiddle & IndexMask;
+
+  if (mConsumerWaiting.load(std::memory_order_seq_cst)) {
+    // the consumer holds the lock until it sleeps, so the notification cannot come too early
+    { std::lock_guard<std::mutex> lock{mWaitMutex}; }
+    mPublished.notify_one();
+  }
+}
+
+template <typename T> bool TripleBuffer<T>::consume() {
+  if ((mMiddle.load(std::memory_order_relaxed) & DirtyBit) == 0) {
+    return false;
+  }
+
+  uint8_t const previousMiddle = mMiddle.exchange(mFront, std::memory_order_acq_rel);
+  mFront = previousMiddle & IndexMask;
+  return true;
+}
+
+template <typename T> T &TripleBuffer<T>::front() { return mBuffers[mFront]; }
+
+template <typename T> bool TripleBuffer<T>::waitForPublish() {
+  if ((mMiddle.load(std::memory_order_acquire) & DirtyBit) != 0) {
+    return true;
+  }
+
+  std::unique_lock<std::mutex> lock{mWaitMutex};
+  mConsumerWaiting.store(true, std::memory_order_seq_cst);
+  mPublished.wait(lock, [this]() {
+    return mClosed || (mMiddle.load(std::memory_order_seq_cst) & DirtyBit) != 0;
+  });
+  mConsumerWaiting.store(false, std::memory_order_relaxed);
+
+  return !mClosed;
+}
+
+template <typename T> void TripleBuffer<T>::close() {
+  {
+    std::lock_guard<std::mutex> lock{mWaitMutex};
+    mClosed = true;
+  }
+  mPublished.notify_one();
+}
+
+template <typename T> void TripleBuffer<T>::open() {
+  std::lock_guard<std::mutex> lock{mWaitMutex};
+  mClosed = false;
+}
+} // namespace cbl
@@ -1,17 +1,63 @@
 #include "Time.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 #include <SDL2/SDL.h>
 
 namespace cbl {
+namespace {
+// sleeps until the given number of seconds has passed since the counter was taken
+void sleepUntil(uint64_t const &counter, double const &seconds) {
+  double const elapsedSeconds = static_cast<double>(SDL_GetPerformanceCounter() - counter) /
+                                static_cast<double>(SDL_GetPerformanceFrequency());
+  double const remainingSeconds = seconds - elapsedSeconds;
+
+  if (remainingSeconds > 0.0) {
+    std::this_thread::sleep_for(std::chrono::duration<double>{remainingSeconds});
+  }
+}
+} // namespace
 
-uint32_t Time::mLastTick = 0;
-float Time::mDeltaSeconds = 0.0f;
+uint64_t Time::mLastCounter = 0;
+double Time::mAccumulatedSeconds = 0.0;
+float Time::mFrameSeconds = 0.0f;
 
 void Time::tick() {
-  uint32_t tickTime = SDL_GetTicks();
-  mDeltaSeconds = static_cast<float>(tickTime - mLastTick) / 1000;
-  mLastTick = tickTime;
+  uint64_t const counter = SDL_GetPerformanceCounter();
+
+  if (mLastCounter == 0) {
+    mLastCounter = counter;
+  }
+
+  double const elapsedSeconds = static_cast<double>(counter - mLastCounter) /
+                                static_cast<double>(SDL_GetPerformanceFrequency());
+  mLastCounter = counter;
+  mFrameSeconds = static_cast<float>(elapsedSeconds);
+
+  mAccumulatedSeconds = std::min(mAccumulatedSeconds + elapsedSeconds,
+                                 static_cast<double>(FixedStepSeconds) * MaxStepsPerFrame);
+}
+
+bool Time::consumeFixedStep() {
+  if (mAccumulatedSeconds < FixedStepSeconds) {
+    return false;
+  }
+
+  mAccumulatedSeconds -= FixedStepSeconds;
+  return true;
 }
 
-float Time::deltaSeconds() { return mDeltaSeconds; }
-} // namespace flex
\ No newline at end of file
+void Time::waitForFixedStep() { sleepUntil(mLastCounter, FixedStepSeconds - mAccumulatedSeconds); }
+
+void Time::waitForFrame() { sleepUntil(mLastCounter, MinFrameSeconds); }
+
+float Time::deltaSeconds() { return FixedStepSeconds; }
+
+float Time::frameSeconds() { return mFrameSeconds; }
+
+float Time::interpolationAlpha() {
+  return static_cast<float>(mAccumulatedSeconds / FixedStepSeconds);
+}
+} // namespace flex
@@ -7,10 +7,22 @@
 namespace cbl {
 struct Time {
 private:
-  static uint32_t mLastTick;
-  static float mDeltaSeconds;
+  static constexpr float FixedStepSeconds = 1.0f / 60.0f;
+  // frames slower than this many steps drop the extra time instead of spiraling
+  static constexpr unsigned int MaxStepsPerFrame = 5;
+  // the main loop does not wait on the render thread, so it caps its own rate
+  static constexpr float MinFrameSeconds = 1.0f / 240.0f;
+
+  static uint64_t mLastCounter;
+  static double mAccumulatedSeconds;
+  static float mFrameSeconds;
 
   static void tick();
+  [[nodiscard]] static bool consumeFixedStep();
+  // sleeps until the next step is due, for frames that have nothing else to wait on
+  static void waitForFixedStep();
+  // sleeps until the current frame has lasted at least MinFrameSeconds
+  static void waitForFrame();
   friend struct gfx::Engine;
 
 public:
@@ -19,6 +31,11 @@ public:
   Time(Time const &) = delete;
   ~Time() = delete;
 
+  // duration of a simulation step
   static float deltaSeconds();
+  // real duration of the last rendered frame
+  static float frameSeconds();
+  // how far the current time is between the last two simulation steps, from 0 to 1
+  static float interpolationAlpha();
 };
-} // namespace cbl
\ No newline at end of file
+} // namespace cbl
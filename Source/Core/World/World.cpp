@@ -1,5 +1,13 @@
 #include "World.hpp"
 
 namespace cbl {
-void World::update() { camera.update(); }
+void World::update() {
+  camera.update();
+
+  if (onUpdate) {
+    onUpdate(*this);
+  }
+}
+
+void World::invalidateMesh(std::size_t const &meshIndex) { mDirtyMeshes.push_back(meshIndex); }
 } // namespace flex
\ No newline at end of file
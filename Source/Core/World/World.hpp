@@ -1,11 +1,12 @@
 #pragma once
 
+#include <functional>
 #include <map>
 #include <vector>
 
+#include "Game/MeshData/MeshData.hpp"
 #include "Graphics/Camera/Camera.hpp"
 #include "Graphics/Materials/BaseMaterial.hpp"
-#include "Graphics/Mesh/Mesh.hpp"
 #include "Graphics/Shaders/BaseShader.hpp"
 
 namespace cbl {
@@ -15,14 +16,22 @@ struct Engine;
 
 struct World {
 private:
+  std::vector<std::size_t> mDirtyMeshes;
+
   void update();
 
   friend struct gfx::Engine;
 
 public:
   gfx::Camera camera;
-  std::vector<gfx::Mesh> meshes;
+  std::vector<MeshData> meshes;
   std::vector<gfx::BaseShader *> shaders;
   std::vector<gfx::BaseMaterial *> materials;
+
+  // game logic run on every simulation step, after the camera moved
+  std::function<void(World &)> onUpdate;
+
+  // schedules meshes[meshIndex] to be sent to the renderer again
+  void invalidateMesh(std::size_t const &meshIndex);
 };
 } // namespace cbl
\ No newline at end of file
@@ -1,131 +1,54 @@
 #include "Block.hpp"
 
-#include "Game/Chunks/Chunk.hpp"
+#include <array>
+#include <cstddef>
 
 namespace cbl {
+namespace {
+constexpr std::array<uint32_t, 6> FaceIndices{0, 1, 3, 3, 2, 0};
 
-std::pair<std::vector<uint32_t>, std::vector<gfx::Vertex>>
-Block::getVertices(Block::Side const &side, Type const &type) {
-  std::pair<std::vector<uint32_t>, std::vector<gfx::Vertex>> sideData{{}, {}};
+// corners of the face on each side, in the order FaceIndices expects
+std::array<std::array<glm::vec3, 4>, 6> const SideCorners{{
+    {{{0.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f}}}, // front
+    {{{1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 0.0f}}}, // right
+    {{{1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}}}, // back
+    {{{0.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}}}, // left
+    {{{0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}}}, // top
+    {{{0.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}}}, // bottom
+}};
 
-  switch (side) {
-  case Side::eFront:
-    switch (type) {
-    case Type::eAir:
-      break;
-    case Type::eGrass:
-      sideData = {{0, 1, 3, 3, 2, 0},
-                  {{{0.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}},
-                   {{1.0f, 1.0f, 1.0f}, {1.0f, 0.0f, 0.0f}},
-                   {{0.0f, 0.0f, 1.0f}, {0.0, 1.0f, 0.0f}},
-                   {{1.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 0.0f}}}};
-      break;
-    case Type::eDirt:
-      sideData = {{0, 1, 3, 3, 2, 0},
-                  {{{0.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 2.0f}},
-                   {{1.0f, 1.0f, 1.0f}, {1.0f, 0.0f, 2.0f}},
-                   {{0.0f, 0.0f, 1.0f}, {0.0, 1.0f, 2.0f}},
-                   {{1.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 2.0f}}}};
-      break;
-    }
-    break;
-  case Side::eRight:
-    switch (type) {
-    case Type::eAir:
-      break;
-    case Type::eGrass:
-      sideData = {{0, 1, 3, 3, 2, 0},
-                  {{{1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 0.0f}},
-                   {{1.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}},
-                   {{1.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f}},
-                   {{1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}}}};
-      break;
-    case Type::eDirt:
-      sideData = {{0, 1, 3, 3, 2, 0},
-                  {{{1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 2.0f}},
-                   {{1.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 2.0f}},
-                   {{1.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 2.0f}},
-                   {{1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 2.0f}}}};
-      break;
-    }
-    break;
-  case Side::eBack:
-    switch (type) {
-    case Type::eAir:
-      break;
-    case Type::eGrass:
-      sideData = {{0, 1, 3, 3, 2, 0},
-                  {{{1.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f}},
-                   {{0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 0.0f}},
-                   {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
-                   {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}}}};
-      break;
-    case Type::eDirt:
-      sideData = {{0, 1, 3, 3, 2, 0},
-                  {{{1.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 2.0f}},
-                   {{0.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 2.0f}},
-                   {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 2.0f}},
-                   {{0.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 2.0f}}}};
-      break;
-    }
-    break;
-  case Side::eLeft:
-    switch (type) {
-    case Type::eAir:
-      break;
-    case Type::eGrass:
-      sideData = {{0, 1, 3, 3, 2, 0},
-                  {{{0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 0.0f}},
-                   {{0.0f, 1.0f, 1.0f}, {1.0f, 0.0f, 0.0f}},
-                   {{0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}},
-                   {{0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 0.0f}}}};
-      break;
-    case Type::eDirt:
-      sideData = {{0, 1, 3, 3, 2, 0},
-                  {{{0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 2.0f}},
-                   {{0.0f, 1.0f, 1.0f}, {1.0f, 0.0f, 2.0f}},
-                   {{0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 2.0f}},
-                   {{0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 2.0f}}}};
-      break;
-    }
-    break;
-  case Side::eTop:
-    switch (type) {
-    case Type::eAir:
-      break;
-    case Type::eGrass:
-      sideData = {{0, 1, 3, 3, 2, 0},
-                  {{{0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}},
-                   {{1.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 1.0f}},
-                   {{0.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 1.0f}},
-                   {{1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f}}}};
-      break;
-    case Type::eDirt:
-      sideData = {{0, 1, 3, 3, 2, 0},
-                  {{{0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 2.0f}},
-                   {{1.0f, 1.0f, 0.0f}, {1.0f, 0.0f, 2.0f}},
-                   {{0.0f, 1.0f, 1.0f}, {0.0f, 1.0f, 2.0f}},
-                   {{1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 2.0f}}}};
-      break;
-    }
-    break;
-  case Side::eBottom:
-    switch (type) {
-    case Type::eAir:
-      break;
-    case Type::eGrass:
-    case Type::eDirt:
-      sideData = {{0, 1, 3, 3, 2, 0},
-                  {{{0.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 2.0f}},
-                   {{1.0f, 0.0f, 1.0f}, {1.0f, 0.0f, 2.0f}},
-                   {{0.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 2.0f}},
-                   {{1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 2.0f}}}};
-      break;
-    }
-    break;
+std::array<glm::vec2, 4> const CornerUVs{
+    {{0.0f, 0.0f}, {1.0f, 0.0f}, {0.0f, 1.0f}, {1.0f, 1.0f}}};
+
+float getTextureLayer(Block::Side const &side, Block::Type const &type) {
+  // grass has its own top and sides, its bottom is dirt
+  if (type == Block::Type::eGrass && side == Block::Side::eTop) {
+    return 1.0f;
+  }
+  if (type == Block::Type::eGrass && side != Block::Side::eBottom) {
+    return 0.0f;
   }
 
-  return sideData;
+  return 2.0f;
 }
+} // namespace
+
+void Block::addFace(MeshData &target, Side const &side, Type const &type,
+                    glm::vec3 const &origin) {
+  if (type == Type::eAir) {
+    return;
+  }
 
+  auto const indexOffset = static_cast<uint32_t>(target.vertices.size());
+  for (uint32_t const &index : FaceIndices) {
+    target.indices.push_back(index + indexOffset);
+  }
+
+  std::array<glm::vec3, 4> const &corners = SideCorners[static_cast<std::size_t>(side)];
+  float const layer = getTextureLayer(side, type);
+  for (std::size_t corner = 0; corner < corners.size(); corner++) {
+    target.vertices.push_back(
+        MeshVertex{origin + corners[corner], glm::vec3{CornerUVs[corner], layer}});
+  }
+}
 } // namespace cbl
@@ -1,19 +1,21 @@
 #pragma once
 
-#include <algorithm>
-#include <vector>
+#include <cstdint>
 
-#include "Graphics/Vertex/Vertex.hpp"
+#include <glm/glm.hpp>
 
-namespace cbl {
-struct Chunk;
+#include "Game/MeshData/MeshData.hpp"
 
+namespace cbl {
 struct Block {
 public:
   enum class Type { eAir, eGrass, eDirt };
+  static constexpr uint8_t TypeCount = 3;
   enum class Side { eFront, eRight, eBack, eLeft, eTop, eBottom };
 
-  [[nodiscard]] static std::pair<std::vector<uint32_t>, std::vector<gfx::Vertex>>
-  getVertices(Side const &side, Type const &type);
+  // appends the face of a block at origin to target, air has no faces
+  // the face data is static, so nothing is allocated once target has grown to its usual size
+  static void addFace(MeshData &target, Side const &side, Type const &type,
+                      glm::vec3 const &origin);
 };
-} // namespace cbl
\ No newline at end of file
+} // namespace cbl
@@ -0,0 +1,53 @@
+#include "ChunkMeshSlots.hpp"
+
+namespace cbl {
+void ChunkMeshSlots::freeSlot(ChunkResidency &residency, World &world, int const &posX,
+                              int const &posY, int const &posZ) {
+  std::size_t const *slot = mSlots.find(posX, posY, posZ);
+  if (slot == nullptr) {
+    return;
+  }
+
+  residency.recycleMesh(std::move(world.meshes[*slot]));
+  world.meshes[*slot] = MeshData{};
+  world.invalidateMesh(*slot);
+  mFreeSlots.push_back(*slot);
+  mSlots.erase(posX, posY, posZ);
+}
+
+void ChunkMeshSlots::sync(ChunkResidency &residency, World &world) {
+  residency.takeEvictedChunks(mEvictedChunks);
+  for (std::pair<int, int> const &position : mEvictedChunks) {
+    for (int y = 0; y < static_cast<int>(Chunk::ColumnSections); y++) {
+      freeSlot(residency, world, position.first, y, position.second);
+    }
+  }
+
+  residency.takeRemeshedChunks(mRemeshedChunks);
+  for (RemeshedChunk &remeshed : mRemeshedChunks) {
+    // buried sections have nothing to draw, so they do not take a slot
+    if (remeshed.mesh.indices.empty()) {
+      freeSlot(residency, world, remeshed.posX, remeshed.posY, remeshed.posZ);
+      residency.recycleMesh(std::move(remeshed.mesh));
+      continue;
+    }
+
+    std::size_t *slot = mSlots.find(remeshed.posX, remeshed.posY, remeshed.posZ);
+
+    if (slot == nullptr) {
+      std::size_t index = world.meshes.size();
+      if (!mFreeSlots.empty()) {
+        index = mFreeSlots.back();
+        mFreeSlots.pop_back();
+      } else {
+        world.meshes.emplace_back();
+      }
+      slot = &mSlots.insert(remeshed.posX, remeshed.posY, remeshed.posZ, index);
+    }
+
+    std::swap(world.meshes[*slot], remeshed.mesh);
+    residency.recycleMesh(std::move(remeshed.mesh));
+    world.invalidateMesh(*slot);
+  }
+}
+} // namespace cbl
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Core/World/World.hpp"
+#include "Game/Chunks/ChunkMap/ChunkMap.hpp"
+#include "Game/Chunks/Residency/ChunkResidency.hpp"
+
+namespace cbl {
+// mirrors the resident sections into world.meshes, reusing the slots of dropped sections
+// replaced meshes go back to the residency so their capacity serves later rebuilds
+struct ChunkMeshSlots {
+private:
+  ChunkMap<std::size_t> mSlots{};
+  std::vector<std::size_t> mFreeSlots{};
+
+  std::vector<RemeshedChunk> mRemeshedChunks{};
+  std::vector<std::pair<int, int>> mEvictedChunks{};
+
+  void freeSlot(ChunkResidency &residency, World &world, int const &posX, int const &posY,
+                int const &posZ);
+
+public:
+  void sync(ChunkResidency &residency, World &world);
+};
+} // namespace cbl
@@ -1,94 +1,286 @@
 #include "Chunk.hpp"
 
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Core/Memory/AllocationTracker/AllocationTracker.hpp"
+#include "Core/Profiler/Profiler.hpp"
+
 namespace cbl {
+namespace {
+constexpr std::array<int, 3> Size{static_cast<int>(Chunk::BlocksX),
+                                  static_cast<int>(Chunk::BlocksY),
+                                  static_cast<int>(Chunk::BlocksZ)};
 
-void Chunk::addSideToMesh(
-    int const &x, int const &y, int const &z,
-    std::pair<std::vector<uint32_t>, std::vector<gfx::Vertex>> const &sideData) {
+// whether every block is air, or every block is not
+bool isAll(Chunk::Blocks const &blocks, bool const &air) {
+  for (auto const &plane : blocks) {
+    for (auto const &row : plane) {
+      for (Block::Type const &block : row) {
+        if ((block == Block::Type::eAir) != air) {
+          return false;
+        }
+      }
+    }
+  }
 
-  auto indexOffset = static_cast<uint32_t>(mesh.vertices.size());
-  mesh.indices.reserve(sideData.first.size());
+  return true;
+}
+} // namespace
 
-  for (uint32_t const &index : sideData.first) {
-    mesh.indices.push_back(index + indexOffset);
+std::array<int, 3> Chunk::getOffset(Block::Side const &side) {
+  switch (side) {
+  case Block::Side::eFront:
+    return {0, 0, 1};
+  case Block::Side::eRight:
+    return {1, 0, 0};
+  case Block::Side::eBack:
+    return {0, 0, -1};
+  case Block::Side::eLeft:
+    return {-1, 0, 0};
+  case Block::Side::eTop:
+    return {0, 1, 0};
+  case Block::Side::eBottom:
+    break;
   }
 
-  mesh.vertices.reserve(sideData.second.size());
+  return {0, -1, 0};
+}
 
-  for (gfx::Vertex const &vertex : sideData.second) {
-    mesh.vertices.push_back(gfx::Vertex{{vertex.position.x + static_cast<float>(x),
-                                         vertex.position.y + static_cast<float>(y),
-                                         vertex.position.z + static_cast<float>(z)},
-                                        {vertex.uvw}});
+Block::Side Chunk::getOpposite(Block::Side const &side) {
+  switch (side) {
+  case Block::Side::eFront:
+    return Block::Side::eBack;
+  case Block::Side::eRight:
+    return Block::Side::eLeft;
+  case Block::Side::eBack:
+    return Block::Side::eFront;
+  case Block::Side::eLeft:
+    return Block::Side::eRight;
+  case Block::Side::eTop:
+    return Block::Side::eBottom;
+  case Block::Side::eBottom:
+    break;
   }
+
+  return Block::Side::eTop;
 }
 
-void Chunk::rebuildMesh() {
-  mesh.indices.clear();
-  mesh.vertices.clear();
+uint8_t Chunk::getSideBit(Block::Side const &side) {
+  return static_cast<uint8_t>(1u << static_cast<unsigned int>(side));
+}
 
-  for (int x = 0; x < Chunk::BlocksX; x++) {
-    for (int y = 0; y < Chunk::BlocksY; y++) {
-      for (int z = 0; z < Chunk::BlocksZ; z++) {
-        Block::Type currentBlock = blocks[x][y][z];
-
-        if (x == 0) {
-          if (neighbourXMinus != nullptr) {
-            if (neighbourXMinus->blocks[BlocksX - 1][y][z] == Block::Type::eAir) {
-              addSideToMesh(x, y, z, Block::getVertices(Block::Side::eLeft, currentBlock));
-            }
-          } else {
-            addSideToMesh(x, y, z, Block::getVertices(Block::Side::eLeft, currentBlock));
-          }
-        } else if (blocks[x - 1][y][z] == Block::Type::eAir) {
-          addSideToMesh(x, y, z, Block::getVertices(Block::Side::eLeft, currentBlock));
+Chunk *Chunk::getNeighbour(Block::Side const &side) const {
+  switch (side) {
+  case Block::Side::eFront:
+    return neighbourZPlus;
+  case Block::Side::eRight:
+    return neighbourXPlus;
+  case Block::Side::eBack:
+    return neighbourZMinus;
+  case Block::Side::eLeft:
+    return neighbourXMinus;
+  case Block::Side::eTop:
+    return neighbourYPlus;
+  case Block::Side::eBottom:
+    break;
+  }
+
+  return neighbourYMinus;
+}
+
+void Chunk::setNeighbour(Block::Side const &side, Chunk *neighbour) {
+  switch (side) {
+  case Block::Side::eFront:
+    neighbourZPlus = neighbour;
+    return;
+  case Block::Side::eRight:
+    neighbourXPlus = neighbour;
+    return;
+  case Block::Side::eBack:
+    neighbourZMinus = neighbour;
+    return;
+  case Block::Side::eLeft:
+    neighbourXMinus = neighbour;
+    return;
+  case Block::Side::eTop:
+    neighbourYPlus = neighbour;
+    return;
+  case Block::Side::eBottom:
+    neighbourYMinus = neighbour;
+    return;
+  }
+}
+
+void Chunk::buildInterior() {
+  mInteriorMesh.indices.clear();
+  mInteriorMesh.vertices.clear();
+
+  for (int x = 0; x < Size[0]; x++) {
+    for (int y = 0; y < Size[1]; y++) {
+      for (int z = 0; z < Size[2]; z++) {
+        Block::Type const currentBlock = blocks[x][y][z];
+        if (currentBlock == Block::Type::eAir) {
+          continue;
         }
 
-        if (x == Chunk::BlocksX - 1) {
-          if (neighbourXPlus != nullptr) {
-            if (neighbourXPlus->blocks[0][y][z] == Block::Type::eAir) {
-              addSideToMesh(x, y, z, Block::getVertices(Block::Side::eRight, currentBlock));
-            }
-          } else {
-            addSideToMesh(x, y, z, Block::getVertices(Block::Side::eRight, currentBlock));
+        for (Block::Side const &side : Sides) {
+          std::array<int, 3> const offset = getOffset(side);
+          int const nextX = x + offset[0];
+          int const nextY = y + offset[1];
+          int const nextZ = z + offset[2];
+
+          // faces leaving the chunk belong to a border
+          if (nextX < 0 || nextX >= Size[0] || nextY < 0 || nextY >= Size[1] || nextZ < 0 ||
+              nextZ >= Size[2]) {
+            continue;
           }
-        } else if (blocks[x + 1][y][z] == Block::Type::eAir) {
-          addSideToMesh(x, y, z, Block::getVertices(Block::Side::eRight, currentBlock));
-        }
 
-        if (y == 0 || blocks[x][y - 1][z] == Block::Type::eAir) {
-          addSideToMesh(x, y, z, Block::getVertices(Block::Side::eBottom, currentBlock));
+          if (blocks[nextX][nextY][nextZ] == Block::Type::eAir) {
+            Block::addFace(mInteriorMesh, side, currentBlock, glm::vec3(x, y, z));
+          }
         }
+      }
+    }
+  }
+}
 
-        if (y == Chunk::BlocksY - 1 || blocks[x][y + 1][z] == Block::Type::eAir) {
-          addSideToMesh(x, y, z, Block::getVertices(Block::Side::eTop, currentBlock));
-        }
+void Chunk::buildBorder(Block::Side const &side) {
+  MeshData &border = mBorderMeshes[static_cast<std::size_t>(side)];
+  border.indices.clear();
+  border.vertices.clear();
 
-        if (z == 0) {
-          if (neighbourZMinus != nullptr) {
-            if (neighbourZMinus->blocks[x][y][BlocksZ - 1] == Block::Type::eAir) {
-              addSideToMesh(x, y, z, Block::getVertices(Block::Side::eBack, currentBlock));
-            }
-          } else {
-            addSideToMesh(x, y, z, Block::getVertices(Block::Side::eBack, currentBlock));
-          }
-        } else if (blocks[x][y][z - 1] == Block::Type::eAir) {
-          addSideToMesh(x, y, z, Block::getVertices(Block::Side::eBack, currentBlock));
+  std::array<int, 3> const offset = getOffset(side);
+  Chunk const *neighbour = getNeighbour(side);
+
+  // nothing is ever seen from below the world, and a solid neighbour hides the whole border
+  if ((neighbour == nullptr && side == Block::Side::eBottom && position.y <= 0.0f) ||
+      (neighbour != nullptr && neighbour->isSolid())) {
+    return;
+  }
+
+  // the layer of blocks touching that border, faces towards a missing neighbour are kept
+  std::array<int, 3> first{};
+  std::array<int, 3> last{};
+  for (std::size_t axis = 0; axis < 3; axis++) {
+    first[axis] = offset[axis] > 0 ? Size[axis] - 1 : 0;
+    last[axis] = offset[axis] < 0 ? 1 : Size[axis];
+  }
+
+  for (int x = first[0]; x < last[0]; x++) {
+    for (int y = first[1]; y < last[1]; y++) {
+      for (int z = first[2]; z < last[2]; z++) {
+        Block::Type const currentBlock = blocks[x][y][z];
+        if (currentBlock == Block::Type::eAir) {
+          continue;
         }
 
-        if (z == Chunk::BlocksZ - 1) {
-          if (neighbourZPlus != nullptr) {
-            if (neighbourZPlus->blocks[x][y][0] == Block::Type::eAir) {
-              addSideToMesh(x, y, z, Block::getVertices(Block::Side::eFront, currentBlock));
-            }
-          } else {
-            addSideToMesh(x, y, z, Block::getVertices(Block::Side::eFront, currentBlock));
+        if (neighbour != nullptr) {
+          // wraps around to the opposite layer of the neighbour
+          int const nextX = (x + offset[0] + Size[0]) % Size[0];
+          int const nextY = (y + offset[1] + Size[1]) % Size[1];
+          int const nextZ = (z + offset[2] + Size[2]) % Size[2];
+          if (neighbour->blocks[nextX][nextY][nextZ] != Block::Type::eAir) {
+            continue;
           }
-        } else if (blocks[x][y][z + 1] == Block::Type::eAir) {
-          addSideToMesh(x, y, z, Block::getVertices(Block::Side::eFront, currentBlock));
         }
+
+        Block::addFace(border, side, currentBlock, glm::vec3(x, y, z));
       }
     }
   }
 }
-} // namespace cbl
\ No newline at end of file
+
+void Chunk::assembleMesh() {
+  std::size_t indexCount = mInteriorMesh.indices.size();
+  std::size_t vertexCount = mInteriorMesh.vertices.size();
+  for (MeshData const &border : mBorderMeshes) {
+    indexCount += border.indices.size();
+    vertexCount += border.vertices.size();
+  }
+
+  mesh.indices.clear();
+  mesh.vertices.clear();
+  mesh.indices.reserve(indexCount);
+  mesh.vertices.reserve(vertexCount);
+
+  auto const append = [this](MeshData const &part) {
+    auto const indexOffset = static_cast<uint32_t>(mesh.vertices.size());
+    for (uint32_t const &index : part.indices) {
+      mesh.indices.push_back(index + indexOffset);
+    }
+    mesh.vertices.insert(mesh.vertices.end(), part.vertices.begin(), part.vertices.end());
+  };
+
+  append(mInteriorMesh);
+  for (MeshData const &border : mBorderMeshes) {
+    append(border);
+  }
+}
+
+void Chunk::placeAt(int const &posX, int const &posY, int const &posZ) {
+  position = glm::vec3{posX * static_cast<int>(BlocksX), posY * static_cast<int>(BlocksY),
+                       posZ * static_cast<int>(BlocksZ)};
+  mesh.position = glm::translate(glm::mat4{1.0f}, position);
+}
+
+bool Chunk::isEmpty() const { return isAll(blocks, true); }
+
+bool Chunk::isSolid() const { return isAll(blocks, false); }
+
+void Chunk::rebuildMesh() {
+  CBL_PROFILE_SCOPE("Chunk::rebuildMesh");
+  CBL_ALLOCATION_SCOPE("Meshing");
+
+  if (isSolid()) {
+    mInteriorMesh.indices.clear();
+    mInteriorMesh.vertices.clear();
+  } else {
+    buildInterior();
+  }
+  for (Block::Side const &side : Sides) {
+    buildBorder(side);
+  }
+  mMeshPartsBuilt = true;
+
+  assembleMesh();
+}
+
+void Chunk::rebuild(uint8_t const &parts) {
+  if (!mMeshPartsBuilt || (parts & WholeMesh) != 0) {
+    rebuildMesh();
+    return;
+  }
+
+  CBL_PROFILE_SCOPE("Chunk::rebuild borders");
+  CBL_ALLOCATION_SCOPE("Meshing");
+
+  for (Block::Side const &side : Sides) {
+    if ((parts & getSideBit(side)) != 0) {
+      buildBorder(side);
+    }
+  }
+  assembleMesh();
+}
+
+bool Chunk::isMeshBuilt() const { return mMeshPartsBuilt; }
+
+void Chunk::clearMesh() {
+  mesh.indices.clear();
+  mesh.vertices.clear();
+  mInteriorMesh.indices.clear();
+  mInteriorMesh.vertices.clear();
+  for (MeshData &border : mBorderMeshes) {
+    border.indices.clear();
+    border.vertices.clear();
+  }
+  mMeshPartsBuilt = false;
+}
+
+std::size_t Chunk::getReservedMeshSize() const {
+  std::size_t size = mesh.getReservedSize() + mInteriorMesh.getReservedSize();
+  for (MeshData const &border : mBorderMeshes) {
+    size += border.getReservedSize();
+  }
+  return size;
+}
+} // namespace cbl
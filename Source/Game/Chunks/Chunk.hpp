@@ -1,32 +1,76 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <glm/glm.hpp>
 
-#include "Core/World/World.hpp"
 #include "Game/Block/Block.hpp"
-#include "Graphics/Mesh/Mesh.hpp"
+#include "Game/MeshData/MeshData.hpp"
 
 namespace cbl {
 struct Chunk {
 private:
-  void addSideToMesh(int const &x, int const &y, int const &z,
-                     std::pair<std::vector<uint32_t>, std::vector<gfx::Vertex>> const &sideData);
+  // faces between two blocks of this chunk, and the outward faces of each border, which only
+  // depend on the neighbour on that side
+  MeshData mInteriorMesh{};
+  std::array<MeshData, 6> mBorderMeshes{};
+  bool mMeshPartsBuilt{false};
+
+  void buildInterior();
+  void buildBorder(Block::Side const &side);
+  void assembleMesh();
 
 public:
   static constexpr unsigned int BlocksX = 16;
   static constexpr unsigned int BlocksY = 16;
   static constexpr unsigned int BlocksZ = 16;
+  // chunks are sections of a column, stacked from y = 0 up to ColumnSections * BlocksY blocks
+  static constexpr unsigned int ColumnSections = 16;
+  static constexpr std::array<Block::Side, 6> Sides{Block::Side::eFront, Block::Side::eRight,
+                                                    Block::Side::eBack,  Block::Side::eLeft,
+                                                    Block::Side::eTop,   Block::Side::eBottom};
+  // in the masks taken by rebuild, along with getSideBit for single borders
+  static constexpr uint8_t WholeMesh = 1u << 6;
+
+  using Blocks = std::array<std::array<std::array<Block::Type, BlocksZ>, BlocksY>, BlocksX>;
 
-  std::array<std::array<std::array<Block::Type, BlocksZ>, BlocksY>, BlocksX> blocks{
-      Block::Type::eAir};
-  gfx::Mesh mesh{{}, {}};
+  Blocks blocks{Block::Type::eAir};
+  MeshData mesh{};
   glm::vec3 position{0};
 
   Chunk *neighbourXPlus{nullptr};
   Chunk *neighbourXMinus{nullptr};
   Chunk *neighbourZPlus{nullptr};
   Chunk *neighbourZMinus{nullptr};
+  Chunk *neighbourYPlus{nullptr};
+  Chunk *neighbourYMinus{nullptr};
+
+  // chunk coordinates of the neighbour on side, relative to this chunk
+  [[nodiscard]] static std::array<int, 3> getOffset(Block::Side const &side);
+  [[nodiscard]] static Block::Side getOpposite(Block::Side const &side);
+  // bit of side in the masks taken by rebuild
+  [[nodiscard]] static uint8_t getSideBit(Block::Side const &side);
+
+  [[nodiscard]] Chunk *getNeighbour(Block::Side const &side) const;
+  void setNeighbour(Block::Side const &side, Chunk *neighbour);
 
+  // moves the chunk and its mesh to chunk coordinates (posX, posY, posZ), posY being the section
+  // in its column
+  void placeAt(int const &posX, int const &posY, int const &posZ);
+  // only air, such sections are not stored
+  [[nodiscard]] bool isEmpty() const;
+  // no air at all, so only its borders can have faces
+  [[nodiscard]] bool isSolid() const;
   void rebuildMesh();
+  // only rebuilds the borders in parts, for when the neighbours on those sides changed
+  // the whole mesh is rebuilt when parts has WholeMesh or the mesh was never built
+  void rebuild(uint8_t const &parts);
+  [[nodiscard]] bool isMeshBuilt() const;
+  // empties the mesh and the parts it is built from, keeping their capacity
+  void clearMesh();
+  // memory held by the mesh and its parts
+  [[nodiscard]] std::size_t getReservedMeshSize() const;
 };
 } // namespace cbl
\ No newline at end of file
@@ -0,0 +1 @@
+#include "ChunkMap.hpp"
@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "Game/Block/Block.hpp"
+#include "Game/Chunks/Chunk.hpp"
+
+namespace cbl {
+// values keyed by chunk coordinates, found through an open addressing table on the packed
+// coordinates
+// values live in pages that never move, so pointers to them survive inserts, erases and rehashes
+// maps of whole columns use the (x, z) overloads, which are the same as y = 0
+template <typename T> struct ChunkMap {
+private:
+  static constexpr std::size_t PageSize = 64;
+  static constexpr uint32_t NoSlot = UINT32_MAX;
+  static constexpr std::size_t MinTableSize = 16;
+
+  struct Slot {
+    uint64_t key = 0;
+    std::optional<T> value{};
+  };
+
+  struct TableEntry {
+    uint64_t key = 0;
+    uint32_t slot = NoSlot;
+  };
+
+  std::vector<std::unique_ptr<Slot[]>> mPages{};
+  std::vector<uint32_t> mFreeSlots{};
+  // linear probing, kept at most half full so probe sequences stay short
+  std::vector<TableEntry> mTable{};
+  std::size_t mSize{0};
+
+  [[nodiscard]] static uint64_t hash(uint64_t key);
+  [[nodiscard]] Slot &getSlot(uint32_t const &slot) const;
+  [[nodiscard]] std::size_t findIndex(uint64_t const &key) const;
+  [[nodiscard]] uint32_t allocateSlot();
+  void rehash(std::size_t const &tableSize);
+
+public:
+  // 24 bits for x and z and 16 bits for y, coordinates outside of that range wrap around
+  [[nodiscard]] static uint64_t pack(int const &x, int const &y, int const &z);
+  [[nodiscard]] static std::tuple<int, int, int> unpack(uint64_t const &key);
+
+  ChunkMap() = default;
+  ChunkMap(ChunkMap const &) = delete;
+  ChunkMap(ChunkMap &&) noexcept = default;
+  ~ChunkMap() = default;
+
+  void operator=(ChunkMap const &) = delete;
+  ChunkMap &operator=(ChunkMap &&) noexcept = default;
+
+  // replaces the value already at (x, y, z) if there is one
+  T &insert(int const &x, int const &y, int const &z, T value);
+  T &insert(int const &x, int const &z, T value);
+  [[nodiscard]] T *find(int const &x, int const &y, int const &z);
+  [[nodiscard]] T *find(int const &x, int const &z);
+  [[nodiscard]] T const *find(int const &x, int const &y, int const &z) const;
+  [[nodiscard]] T const *find(int const &x, int const &z) const;
+  [[nodiscard]] bool contains(int const &x, int const &y, int const &z) const;
+  [[nodiscard]] bool contains(int const &x, int const &z) const;
+  bool erase(int const &x, int const &y, int const &z);
+  bool erase(int const &x, int const &z);
+  void clear();
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] bool empty() const;
+
+  // calls function(x, y, z, value) for every value, which may erase the value it was given
+  template <typename Function> void forEach(Function &&function);
+  template <typename Function> void forEach(Function &&function) const;
+
+  // only for maps of chunks: block at world coordinates, air where no chunk is loaded
+  [[nodiscard]] Block::Type getBlock(int const &worldX, int const &worldY,
+                                     int const &worldZ) const;
+};
+
+template <typename T> uint64_t ChunkMap<T>::pack(int const &x, int const &y, int const &z) {
+  return (static_cast<uint64_t>(static_cast<uint32_t>(x)) & 0xffffffull) << 40 |
+         (static_cast<uint64_t>(static_cast<uint32_t>(y)) & 0xffffull) << 24 |
+         (static_cast<uint64_t>(static_cast<uint32_t>(z)) & 0xffffffull);
+}
+
+template <typename T> std::tuple<int, int, int> ChunkMap<T>::unpack(uint64_t const &key) {
+  // shifting the field to the top and back extends its sign
+  auto const field = [&key](int const &shift, int const &bits) {
+    return static_cast<int>(static_cast<int64_t>(key << (64 - shift - bits)) >> (64 - bits));
+  };
+  return std::make_tuple(field(40, 24), field(24, 16), field(0, 24));
+}
+
+template <typename T> uint64_t ChunkMap<T>::hash(uint64_t key) {
+  // splitmix64 finaliser, neighbouring coordinates end up far apart in the table
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ull;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebull;
+  key ^= key >> 31;
+  return key;
+}
+
+template <typename T> typename ChunkMap<T>::Slot &ChunkMap<T>::getSlot(uint32_t const &slot) const {
+  return mPages[slot / PageSize][slot % PageSize];
+}
+
+template <typename T> std::size_t ChunkMap<T>::findIndex(uint64_t const &key) const {
+  std::size_t const mask = mTable.size() - 1;
+  std::size_t index = hash(key) & mask;
+
+  while (mTable[index].slot != NoSlot && mTable[index].key != key) {
+    index = (index + 1) & mask;
+  }
+
+  return index;
+}
+
+template <typename T> uint32_t ChunkMap<T>::allocateSlot() {
+  if (mFreeSlots.empty()) {
+    auto const firstSlot = static_cast<uint32_t>(mPages.size() * PageSize);
+    mPages.push_back(std::make_unique<Slot[]>(PageSize));
+
+    // handed out lowest first
+    for (std::size_t i = PageSize; i > 0; i--) {
+      mFreeSlots.push_back(firstSlot + static_cast<uint32_t>(i - 1));
+    }
+  }
+
+  uint32_t const slot = mFreeSlots.back();
+  mFreeSlots.pop_back();
+  return slot;
+}
+
+template <typename T> void ChunkMap<T>::rehash(std::size_t const &tableSize) {
+  std::vector<TableEntry> const previous = std::move(mTable);
+  mTable.assign(tableSize, TableEntry{});
+
+  for (TableEntry const &entry : previous) {
+    if (entry.slot != NoSlot) {
+      mTable[findIndex(entry.key)] = entry;
+    }
+  }
+}
+
+template <typename T> T &ChunkMap<T>::insert(int const &x, int const &y, int const &z, T value) {
+  if ((mSize + 1) * 2 > mTable.size()) {
+    rehash(std::max(MinTableSize, mTable.size() * 2));
+  }
+
+  uint64_t const key = pack(x, y, z);
+  TableEntry &entry = mTable[findIndex(key)];
+
+  if (entry.slot == NoSlot) {
+    entry = TableEntry{key, allocateSlot()};
+    mSize++;
+  }
+
+  Slot &slot = getSlot(entry.slot);
+  slot.key = key;
+  slot.value = std::move(value);
+  return *slot.value;
+}
+
+template <typename T> T &ChunkMap<T>::insert(int const &x, int const &z, T value) {
+  return insert(x, 0, z, std::move(value));
+}
+
+template <typename T> T *ChunkMap<T>::find(int const &x, int const &y, int const &z) {
+  return const_cast<T *>(static_cast<ChunkMap const *>(this)->find(x, y, z));
+}
+
+template <typename T> T *ChunkMap<T>::find(int const &x, int const &z) { return find(x, 0, z); }
+
+template <typename T> T const *ChunkMap<T>::find(int const &x, int const &y, int const &z) const {
+  if (mSize == 0) {
+    return nullptr;
+  }
+
+  TableEntry const &entry = mTable[findIndex(pack(x, y, z))];
+  return entry.slot == NoSlot ? nullptr : &*getSlot(entry.slot).value;
+}
+
+template <typename T> T const *ChunkMap<T>::find(int const &x, int const &z) const {
+  return find(x, 0, z);
+}
+
+template <typename T> bool ChunkMap<T>::contains(int const &x, int const &y, int const &z) const {
+  return find(x, y, z) != nullptr;
+}
+
+template <typename T> bool ChunkMap<T>::contains(int const &x, int const &z) const {
+  return contains(x, 0, z);
+}
+
+template <typename T> bool ChunkMap<T>::erase(int const &x, int const &z) { return erase(x, 0, z); }
+
+template <typename T> bool ChunkMap<T>::erase(int const &x, int const &y, int const &z) {
+  if (mSize == 0) {
+    return false;
+  }
+
+  std::size_t const mask = mTable.size() - 1;
+  std::size_t index = findIndex(pack(x, y, z));
+  if (mTable[index].slot == NoSlot) {
+    return false;
+  }
+
+  getSlot(mTable[index].slot).value.reset();
+  mFreeSlots.push_back(mTable[index].slot);
+  mTable[index] = TableEntry{};
+  mSize--;
+
+  // backward shift deletion, moves later entries of the probe sequence into the hole so no
+  // tombstones are needed
+  for (std::size_t next = (index + 1) & mask; mTable[next].slot != NoSlot;
+       next = (next + 1) & mask) {
+    std::size_t const home = hash(mTable[next].key) & mask;
+
+    // entries whose home lies cyclically in (index, next] are already reachable
+    bool const reachable = index <= next ? (index < home && home <= next)
+                                         : (index < home || home <= next);
+    if (!reachable) {
+      mTable[index] = mTable[next];
+      mTable[next] = TableEntry{};
+      index = next;
+    }
+  }
+
+  return true;
+}
+
+template <typename T> void ChunkMap<T>::clear() {
+  forEach([this](int const &x, int const &y, int const &z, T &) { erase(x, y, z); });
+}
+
+template <typename T> std::size_t ChunkMap<T>::size() const { return mSize; }
+
+template <typename T> bool ChunkMap<T>::empty() const { return mSize == 0; }
+
+template <typename T> template <typename Function> void ChunkMap<T>::forEach(Function &&function) {
+  for (std::size_t page = 0; page < mPages.size(); page++) {
+    for (std::size_t i = 0; i < PageSize; i++) {
+      Slot &slot = mPages[page][i];
+      if (slot.value) {
+        auto const [x, y, z] = unpack(slot.key);
+        function(x, y, z, *slot.value);
+      }
+    }
+  }
+}
+
+template <typename T>
+template <typename Function>
+void ChunkMap<T>::forEach(Function &&function) const {
+  for (std::size_t page = 0; page < mPages.size(); page++) {
+    for (std::size_t i = 0; i < PageSize; i++) {
+      Slot const &slot = mPages[page][i];
+      if (slot.value) {
+        auto const [x, y, z] = unpack(slot.key);
+        function(x, y, z, *slot.value);
+      }
+    }
+  }
+}
+
+template <typename T>
+Block::Type ChunkMap<T>::getBlock(int const &worldX, int const &worldY, int const &worldZ) const {
+  auto const sizeX = static_cast<int>(Chunk::BlocksX);
+  auto const sizeY = static_cast<int>(Chunk::BlocksY);
+  auto const sizeZ = static_cast<int>(Chunk::BlocksZ);
+  // rounds towards negative infinity so block -1 lands in chunk -1
+  int const chunkX = worldX / sizeX - (worldX % sizeX < 0 ? 1 : 0);
+  int const chunkY = worldY / sizeY - (worldY % sizeY < 0 ? 1 : 0);
+  int const chunkZ = worldZ / sizeZ - (worldZ % sizeZ < 0 ? 1 : 0);
+
+  T const *chunk = find(chunkX, chunkY, chunkZ);
+  if (chunk == nullptr) {
+    return Block::Type::eAir;
+  }
+
+  return chunk->blocks[worldX - chunkX * sizeX][worldY - chunkY * sizeY]
+                      [worldZ - chunkZ * sizeZ];
+}
+} // namespace cbl
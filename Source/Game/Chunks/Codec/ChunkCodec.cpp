@@ -0,0 +1,338 @@
+#include "ChunkCodec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace cbl {
+namespace {
+constexpr std::size_t MaxRunsSize = Chunk::BlocksX * Chunk::BlocksY * Chunk::BlocksZ * 2;
+static_assert(MaxRunsSize + MaxRunsSize / 255 + 16 <= UINT16_MAX,
+              "Frame sizes are stored on 16 bits");
+
+uint32_t read32(uint8_t const *data) {
+  uint32_t value;
+  std::memcpy(&value, data, sizeof(uint32_t));
+  return value;
+}
+
+uint16_t read16(uint8_t const *data) {
+  return static_cast<uint16_t>(data[0] | static_cast<uint16_t>(data[1]) << 8);
+}
+
+void write16(uint8_t *data, std::size_t const &value) {
+  data[0] = static_cast<uint8_t>(value & 0xFF);
+  data[1] = static_cast<uint8_t>(value >> 8);
+}
+
+// lengths of 15 and more spill into extra bytes, 255 at a time
+void writeLength(std::vector<uint8_t> &output, std::size_t length) {
+  for (length -= 15; length >= 255; length -= 255) {
+    output.push_back(255);
+  }
+  output.push_back(static_cast<uint8_t>(length));
+}
+
+bool readLength(uint8_t const *input, std::size_t const &inputSize, std::size_t &position,
+                std::size_t &length) {
+  uint8_t extra = 255;
+  while (extra == 255) {
+    if (position >= inputSize) {
+      return false;
+    }
+    extra = input[position++];
+    length += extra;
+  }
+  return true;
+}
+
+void writeSequence(std::vector<uint8_t> &output, uint8_t const *literals,
+                   std::size_t const &literalLength, std::size_t const &offset,
+                   std::size_t const &matchLength, std::size_t const &minMatch) {
+  std::size_t const storedMatch = matchLength > 0 ? matchLength - minMatch : 0;
+  output.push_back(static_cast<uint8_t>(std::min<std::size_t>(literalLength, 15) << 4 |
+                                        std::min<std::size_t>(storedMatch, 15)));
+
+  if (literalLength >= 15) {
+    writeLength(output, literalLength);
+  }
+  output.insert(output.end(), literals, literals + literalLength);
+
+  if (matchLength == 0) {
+    return;
+  }
+
+  output.push_back(static_cast<uint8_t>(offset & 0xFF));
+  output.push_back(static_cast<uint8_t>(offset >> 8));
+  if (storedMatch >= 15) {
+    writeLength(output, storedMatch);
+  }
+}
+} // namespace
+
+void ChunkCodec::encodeRuns(Chunk::Blocks const &blocks, std::vector<uint8_t> &runs) {
+  // (run length, block type) pairs, one column at a time from bottom to top
+  for (auto const &plane : blocks) {
+    for (unsigned int z = 0; z < Chunk::BlocksZ; z++) {
+      Block::Type runType = plane[0][z];
+      uint8_t runLength = 1;
+
+      for (unsigned int y = 1; y < Chunk::BlocksY; y++) {
+        if (plane[y][z] == runType && runLength < UINT8_MAX) {
+          runLength++;
+          continue;
+        }
+
+        runs.push_back(runLength);
+        runs.push_back(static_cast<uint8_t>(runType));
+        runType = plane[y][z];
+        runLength = 1;
+      }
+
+      runs.push_back(runLength);
+      runs.push_back(static_cast<uint8_t>(runType));
+    }
+  }
+}
+
+bool ChunkCodec::decodeRuns(std::vector<uint8_t> const &runs, Chunk::Blocks &blocks) {
+  constexpr std::size_t ColumnCount = Chunk::BlocksX * Chunk::BlocksZ;
+  std::size_t column = 0;
+  unsigned int y = 0;
+
+  for (std::size_t i = 0; i + 1 < runs.size(); i += 2) {
+    uint8_t const runLength = runs[i];
+    uint8_t const type = runs[i + 1];
+
+    // runs never cross columns
+    if (runLength == 0 || type >= Block::TypeCount || column >= ColumnCount ||
+        y + runLength > Chunk::BlocksY) {
+      return false;
+    }
+
+    auto &plane = blocks[column / Chunk::BlocksZ];
+    for (uint8_t j = 0; j < runLength; j++, y++) {
+      plane[y][column % Chunk::BlocksZ] = static_cast<Block::Type>(type);
+    }
+
+    if (y == Chunk::BlocksY) {
+      column++;
+      y = 0;
+    }
+  }
+
+  return column == ColumnCount && runs.size() % 2 == 0;
+}
+
+void ChunkCodec::compress(std::vector<uint8_t> const &input, std::vector<uint8_t> &output) {
+  // greedy LZ77 with a single-entry hash table, in the spirit of LZ4
+  std::array<int32_t, 1 << HashBits> table{};
+  table.fill(-1);
+
+  std::size_t const inputSize = input.size();
+  std::size_t anchor = 0;
+  std::size_t position = 0;
+
+  while (position + MinMatch <= inputSize) {
+    uint32_t const sequence = read32(input.data() + position);
+    uint32_t const hash = (sequence * 2654435761u) >> (32 - HashBits);
+    int32_t const candidate = table[hash];
+    table[hash] = static_cast<int32_t>(position);
+
+    if (candidate < 0 || position - static_cast<std::size_t>(candidate) > MaxOffset ||
+        read32(input.data() + candidate) != sequence) {
+      position++;
+      continue;
+    }
+
+    std::size_t matchLength = MinMatch;
+    while (position + matchLength < inputSize &&
+           input[candidate + matchLength] == input[position + matchLength]) {
+      matchLength++;
+    }
+
+    writeSequence(output, input.data() + anchor, position - anchor, position - candidate,
+                  matchLength, MinMatch);
+    position += matchLength;
+    anchor = position;
+  }
+
+  // the last sequence only carries literals, which is how the decoder knows where to stop
+  writeSequence(output, input.data() + anchor, inputSize - anchor, 0, 0, MinMatch);
+}
+
+bool ChunkCodec::decompress(uint8_t const *input, std::size_t const &inputSize,
+                            std::vector<uint8_t> &output, std::size_t const &outputSize) {
+  output.clear();
+  output.reserve(outputSize);
+  std::size_t position = 0;
+
+  while (position < inputSize) {
+    uint8_t const token = input[position++];
+
+    std::size_t literalLength = token >> 4;
+    if (literalLength == 15 && !readLength(input, inputSize, position, literalLength)) {
+      return false;
+    }
+    if (position + literalLength > inputSize || output.size() + literalLength > outputSize) {
+      return false;
+    }
+    output.insert(output.end(), input + position, input + position + literalLength);
+    position += literalLength;
+
+    if (position == inputSize) {
+      break;
+    }
+
+    if (position + 2 > inputSize) {
+      return false;
+    }
+    std::size_t const offset = read16(input + position);
+    position += 2;
+
+    std::size_t matchLength = token & 0x0F;
+    if (matchLength == 15 && !readLength(input, inputSize, position, matchLength)) {
+      return false;
+    }
+    matchLength += MinMatch;
+
+    if (offset == 0 || offset > output.size() || output.size() + matchLength > outputSize) {
+      return false;
+    }
+
+    // matches may overlap their own output, so bytes are copied one at a time
+    std::size_t const matchStart = output.size() - offset;
+    for (std::size_t i = 0; i < matchLength; i++) {
+      output.push_back(output[matchStart + i]);
+    }
+  }
+
+  return output.size() == outputSize;
+}
+
+void ChunkCodec::encode(Chunk::Blocks const &blocks, std::vector<uint8_t> &output) {
+  thread_local std::vector<uint8_t> runs{};
+  runs.clear();
+  encodeRuns(blocks, runs);
+
+  std::size_t const frameStart = output.size();
+  output.resize(frameStart + FrameHeaderSize);
+  compress(runs, output);
+
+  // header: format version, size of the runs, size of the compressed runs
+  output[frameStart] = FormatVersion;
+  write16(output.data() + frameStart + 1, runs.size());
+  write16(output.data() + frameStart + 3, output.size() - frameStart - FrameHeaderSize);
+}
+
+std::size_t ChunkCodec::decode(uint8_t const *data, std::size_t const &size,
+                               Chunk::Blocks &blocks) {
+  if (size < FrameHeaderSize || data[0] != FormatVersion) {
+    return 0;
+  }
+
+  std::size_t const runsSize = read16(data + 1);
+  std::size_t const payloadSize = read16(data + 3);
+  if (runsSize > MaxRunsSize || FrameHeaderSize + payloadSize > size) {
+    return 0;
+  }
+
+  thread_local std::vector<uint8_t> runs{};
+  if (!decompress(data + FrameHeaderSize, payloadSize, runs, runsSize) ||
+      !decodeRuns(runs, blocks)) {
+    return 0;
+  }
+
+  return FrameHeaderSize + payloadSize;
+}
+
+void ChunkCodec::encode(Chunk::Blocks const &blocks, std::ostream &output) {
+  thread_local std::vector<uint8_t> frame{};
+  frame.clear();
+  encode(blocks, frame);
+
+  output.write(reinterpret_cast<char const *>(frame.data()),
+               static_cast<std::streamsize>(frame.size()));
+}
+
+bool ChunkCodec::decode(std::istream &input, Chunk::Blocks &blocks) {
+  thread_local std::vector<uint8_t> frame{};
+  frame.resize(FrameHeaderSize);
+
+  if (!input.read(reinterpret_cast<char *>(frame.data()), FrameHeaderSize)) {
+    return false;
+  }
+
+  std::size_t const payloadSize = read16(frame.data() + 3);
+  frame.resize(FrameHeaderSize + payloadSize);
+
+  if (!input.read(reinterpret_cast<char *>(frame.data() + FrameHeaderSize),
+                  static_cast<std::streamsize>(payloadSize))) {
+    return false;
+  }
+
+  return decode(frame.data(), frame.size(), blocks) != 0;
+}
+
+void ChunkCodec::encodeColumn(
+    std::array<Chunk::Blocks const *, Chunk::ColumnSections> const &sections,
+    std::vector<uint8_t> &output) {
+  SectionMask mask = 0;
+  for (unsigned int y = 0; y < Chunk::ColumnSections; y++) {
+    mask |= sections[y] != nullptr ? static_cast<SectionMask>(1u << y) : 0;
+  }
+
+  std::size_t const headerStart = output.size();
+  output.resize(headerStart + ColumnHeaderSize);
+  write16(output.data() + headerStart, mask);
+
+  for (Chunk::Blocks const *blocks : sections) {
+    if (blocks != nullptr) {
+      encode(*blocks, output);
+    }
+  }
+}
+
+ChunkCodec::SectionMask ChunkCodec::getColumnSections(uint8_t const *data,
+                                                    std::size_t const &size) {
+  SectionMask sections = 0;
+  return decodeColumnHeader(data, size, sections) != 0 ? sections : 0;
+}
+
+bool ChunkCodec::decodeSection(uint8_t const *data, std::size_t const &size, int const &y,
+                               Chunk::Blocks &blocks) {
+  SectionMask sections = 0;
+  std::size_t offset = decodeColumnHeader(data, size, sections);
+  if (offset == 0 || y < 0 || y >= static_cast<int>(Chunk::ColumnSections) ||
+      (sections & (1u << y)) == 0) {
+    return false;
+  }
+
+  // frames are self-delimiting, so the sections below are skipped without decoding them
+  for (int below = 0; below < y; below++) {
+    if ((sections & (1u << below)) == 0) {
+      continue;
+    }
+
+    if (size - offset < FrameHeaderSize) {
+      return false;
+    }
+    offset += FrameHeaderSize + read16(data + offset + 3);
+    if (offset > size) {
+      return false;
+    }
+  }
+
+  return decode(data + offset, size - offset, blocks) != 0;
+}
+
+std::size_t ChunkCodec::decodeColumnHeader(uint8_t const *data, std::size_t const &size,
+                                           SectionMask &sections) {
+  if (size < ColumnHeaderSize) {
+    return 0;
+  }
+
+  sections = static_cast<SectionMask>(read16(data));
+  return ColumnHeaderSize;
+}
+} // namespace cbl
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "Game/Chunks/Chunk.hpp"
+
+namespace cbl {
+// lossless chunk compression without external dependencies
+// blocks are run-length encoded along Y, which turns terrain columns into a handful of runs, and
+// the runs go through an LZ pass that replaces columns repeating earlier ones with back-references
+// each encoded chunk is a self-delimiting frame, so frames can be appended to and read from a
+// stream one after the other
+// a column is a mask of its sections holding blocks followed by their frames from the bottom up,
+// so sections of air cost nothing
+struct ChunkCodec {
+public:
+  using SectionMask = uint16_t;
+  static_assert(Chunk::ColumnSections <= 16, "Every section of a column needs a bit in the mask");
+
+private:
+  static constexpr uint8_t FormatVersion = 1;
+  static constexpr std::size_t FrameHeaderSize = 5;
+  static constexpr std::size_t MinMatch = 4;
+  static constexpr std::size_t MaxOffset = UINT16_MAX;
+  static constexpr unsigned int HashBits = 12;
+  static constexpr std::size_t ColumnHeaderSize = sizeof(SectionMask);
+
+  static void encodeRuns(Chunk::Blocks const &blocks, std::vector<uint8_t> &runs);
+  [[nodiscard]] static bool decodeRuns(std::vector<uint8_t> const &runs, Chunk::Blocks &blocks);
+
+  static void compress(std::vector<uint8_t> const &input, std::vector<uint8_t> &output);
+  [[nodiscard]] static bool decompress(uint8_t const *input, std::size_t const &inputSize,
+                                       std::vector<uint8_t> &output,
+                                       std::size_t const &outputSize);
+
+  [[nodiscard]] static std::size_t decodeColumnHeader(uint8_t const *data,
+                                                      std::size_t const &size,
+                                                      SectionMask &sections);
+
+public:
+  ChunkCodec() = delete;
+
+  // appends one frame to output
+  static void encode(Chunk::Blocks const &blocks, std::vector<uint8_t> &output);
+  // decodes the frame at the start of data and returns its size, or 0 if it is invalid or
+  // incomplete
+  [[nodiscard]] static std::size_t decode(uint8_t const *data, std::size_t const &size,
+                                          Chunk::Blocks &blocks);
+
+  static void encode(Chunk::Blocks const &blocks, std::ostream &output);
+  // reads the next frame, returns false at the end of the stream or on invalid data
+  [[nodiscard]] static bool decode(std::istream &input, Chunk::Blocks &blocks);
+
+  // appends a column, sections[y] being the blocks of section y or nullptr when it is all air
+  static void encodeColumn(std::array<Chunk::Blocks const *, Chunk::ColumnSections> const &sections,
+                           std::vector<uint8_t> &output);
+  // sections of an encoded column holding blocks, none if the column is invalid
+  [[nodiscard]] static SectionMask getColumnSections(uint8_t const *data, std::size_t const &size);
+  // decodes section y of a column without the ones before it, returns false if the section is all
+  // air or the column is invalid
+  [[nodiscard]] static bool decodeSection(uint8_t const *data, std::size_t const &size,
+                                          int const &y, Chunk::Blocks &blocks);
+  // decodes a whole column, getBlocks(y) returns where to decode section y for every section
+  // holding blocks, returns false if the column is invalid or incomplete
+  template <typename GetBlocks>
+  [[nodiscard]] static bool decodeColumn(uint8_t const *data, std::size_t const &size,
+                                         GetBlocks &&getBlocks);
+};
+
+template <typename GetBlocks>
+bool ChunkCodec::decodeColumn(uint8_t const *data, std::size_t const &size,
+                              GetBlocks &&getBlocks) {
+  SectionMask sections = 0;
+  std::size_t offset = decodeColumnHeader(data, size, sections);
+  if (offset == 0) {
+    return false;
+  }
+
+  for (unsigned int y = 0; y < Chunk::ColumnSections; y++) {
+    if ((sections & (1u << y)) == 0) {
+      continue;
+    }
+
+    std::size_t const frameSize =
+        decode(data + offset, size - offset, getBlocks(static_cast<int>(y)));
+    if (frameSize == 0) {
+      return false;
+    }
+    offset += frameSize;
+  }
+
+  return offset == size;
+}
+} // namespace cbl
@@ -1,32 +1,58 @@
 #include "ChunkGenerator.hpp"
 
-#include <ctime>
-
-#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <utility>
 
+#include "Core/Profiler/Profiler.hpp"
 #include "External/PerlinNoise/PerlinNoise.hpp"
 
 namespace cbl {
 
-Chunk ChunkGenerator::generate(int const &posX, int const &posZ) {
-  Chunk chunk{};
-  chunk.position = glm::vec3{posX * Chunk::BlocksX, 0.0f, posZ * Chunk::BlocksZ};
-  chunk.mesh.position = glm::translate(glm::mat4{1.0f}, chunk.position);
+ChunkGenerator::Heightmap ChunkGenerator::generateHeightmap(int const &posX, int const &posZ,
+                                                            uint32_t const &seed) {
+  CBL_PROFILE_SCOPE("ChunkGenerator::generateHeightmap");
 
-  siv::PerlinNoise perlin(std::time(nullptr));
+  siv::PerlinNoise perlin(seed);
   double frequency = 50.0f;
+  int const worldHeight = static_cast<int>(Chunk::ColumnSections * Chunk::BlocksY);
 
+  Heightmap heightmap{};
   for (int x = 0; x < Chunk::BlocksX; x++) {
-    for (int y = 0; y < Chunk::BlocksY; y++) {
-      for (int z = 0; z < Chunk::BlocksZ; z++) {
-        double noiseValue = perlin.accumulatedOctaveNoise2D_0_1(
-            static_cast<double>(x + static_cast<int>(chunk.position.x)) / frequency,
-            static_cast<double>(z + static_cast<int>(chunk.position.z)) / frequency, 3);
-        int adjustedNoiseValue = floor(noiseValue * Chunk::BlocksY);
-
-        if (y > adjustedNoiseValue) {
+    for (int z = 0; z < Chunk::BlocksZ; z++) {
+      double noiseValue = perlin.accumulatedOctaveNoise2D_0_1(
+          static_cast<double>(x + posX * static_cast<int>(Chunk::BlocksX)) / frequency,
+          static_cast<double>(z + posZ * static_cast<int>(Chunk::BlocksZ)) / frequency, 3);
+      heightmap[x][z] =
+          std::min(static_cast<int>(floor(noiseValue * TerrainHeight)), worldHeight - 1);
+    }
+  }
+
+  return heightmap;
+}
+
+int ChunkGenerator::getTopSection(Heightmap const &heightmap) {
+  int top = 0;
+  for (auto const &row : heightmap) {
+    top = std::max(top, *std::max_element(row.begin(), row.end()));
+  }
+
+  return top / static_cast<int>(Chunk::BlocksY);
+}
+
+void ChunkGenerator::fill(Chunk &chunk, Heightmap const &heightmap, int const &posX,
+                          int const &posY, int const &posZ) {
+  chunk.placeAt(posX, posY, posZ);
+
+  int const bottom = posY * static_cast<int>(Chunk::BlocksY);
+
+  for (int x = 0; x < Chunk::BlocksX; x++) {
+    for (int z = 0; z < Chunk::BlocksZ; z++) {
+      int const surface = heightmap[x][z] - bottom;
+
+      for (int y = 0; y < Chunk::BlocksY; y++) {
+        if (y > surface) {
           chunk.blocks[x][y][z] = Block::Type::eAir;
-        } else if (y == adjustedNoiseValue) {
+        } else if (y == surface) {
           chunk.blocks[x][y][z] = Block::Type::eGrass;
         } else {
           chunk.blocks[x][y][z] = Block::Type::eDirt;
@@ -34,45 +60,49 @@ Chunk ChunkGenerator::generate(int const &posX, int const &posZ) {
       }
     }
   }
+}
 
+Chunk ChunkGenerator::generate(int const &posX, int const &posY, int const &posZ,
+                               uint32_t const &seed) {
+  Chunk chunk{};
+  generate(chunk, posX, posY, posZ, seed);
   return chunk;
 }
 
-std::map<std::pair<int, int>, Chunk> ChunkGenerator::generateMany(int const &numX,
-                                                                  int const &numZ) {
-  std::map<std::pair<int, int>, Chunk> chunks{};
+void ChunkGenerator::generate(Chunk &chunk, int const &posX, int const &posY, int const &posZ,
+                              uint32_t const &seed) {
+  CBL_PROFILE_SCOPE("ChunkGenerator::generate");
 
-  for (int x = 0; x < numX; x++) {
-    for (int z = 0; z < numZ; z++) {
-      chunks[std::make_pair(x, z)] = generate(x, z);
-    }
-  }
+  fill(chunk, generateHeightmap(posX, posZ, seed), posX, posY, posZ);
+}
 
-  for (int x = 0; x < numX; x++) {
-    for (int z = 0; z < numZ; z++) {
-      Chunk &currentChunk = chunks[std::make_pair(x, z)];
+void ChunkGenerator::generateColumn(ChunkGrid &chunks, int const &posX, int const &posZ,
+                                    uint32_t const &seed) {
+  CBL_PROFILE_SCOPE("ChunkGenerator::generateColumn");
 
-      if (x != 0) {
-        currentChunk.neighbourXMinus = &chunks[std::make_pair(x - 1, z)];
-      }
+  Heightmap const heightmap = generateHeightmap(posX, posZ, seed);
 
-      if (x != numX - 1) {
-        currentChunk.neighbourXPlus = &chunks[std::make_pair(x + 1, z)];
-      }
+  for (int y = 0; y <= getTopSection(heightmap); y++) {
+    Chunk chunk{};
+    fill(chunk, heightmap, posX, y, posZ);
+    chunks.insert(posX, y, posZ, std::move(chunk));
+  }
+}
 
-      if (z != 0) {
-        currentChunk.neighbourZMinus = &chunks[std::make_pair(x, z - 1)];
-      }
+ChunkGrid ChunkGenerator::generateMany(int const &numX, int const &numZ) {
+  CBL_PROFILE_SCOPE("ChunkGenerator::generateMany");
 
-      if (z != numZ - 1) {
-        currentChunk.neighbourZPlus = &chunks[std::make_pair(x, z + 1)];
-      }
+  ChunkGrid chunks{};
 
-      currentChunk.rebuildMesh();
+  for (int x = 0; x < numX; x++) {
+    for (int z = 0; z < numZ; z++) {
+      generateColumn(chunks, x, z);
     }
   }
 
+  chunks.rebuildMeshes();
+
   return chunks;
 }
 
-} // namespace cbl
\ No newline at end of file
+} // namespace cbl
@@ -1,13 +1,42 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+
 #include "Game/Chunks/Chunk.hpp"
+#include "Game/Chunks/Grid/ChunkGrid.hpp"
 
 namespace cbl {
 struct ChunkGenerator {
 private:
 public:
-  [[nodiscard]] static Chunk generate(int const &posX, int const &posZ);
-  [[nodiscard]] static std::map<std::pair<int, int>, Chunk> generateMany(int const &numX,
-                                                                         int const &numZ);
+  static constexpr uint32_t DefaultSeed = 1;
+  // highest the terrain surface can get, in blocks
+  static constexpr int TerrainHeight = 64;
+
+  // surface height in blocks of every block column of a chunk column
+  using Heightmap = std::array<std::array<int, Chunk::BlocksZ>, Chunk::BlocksX>;
+
+  // the same seed always gives the same terrain
+  [[nodiscard]] static Heightmap generateHeightmap(int const &posX, int const &posZ,
+                                                   uint32_t const &seed = DefaultSeed);
+  // highest section of a column holding blocks, the ones above it are all air
+  [[nodiscard]] static int getTopSection(Heightmap const &heightmap);
+  // fills the blocks of section posY in the column the heightmap was generated for and places the
+  // chunk
+  static void fill(Chunk &chunk, Heightmap const &heightmap, int const &posX, int const &posY,
+                   int const &posZ);
+
+  [[nodiscard]] static Chunk generate(int const &posX, int const &posY, int const &posZ,
+                                      uint32_t const &seed = DefaultSeed);
+  // fills the blocks of an existing chunk, such as one from a ChunkPool, and places it
+  static void generate(Chunk &chunk, int const &posX, int const &posY, int const &posZ,
+                       uint32_t const &seed = DefaultSeed);
+  // inserts the sections of the column at (posX, posZ) that hold blocks, the ones of air are left
+  // out
+  static void generateColumn(ChunkGrid &chunks, int const &posX, int const &posZ,
+                             uint32_t const &seed = DefaultSeed);
+  // numX by numZ columns, the chunks come back linked and meshed
+  [[nodiscard]] static ChunkGrid generateMany(int const &numX, int const &numZ);
 };
-} // namespace cbl
\ No newline at end of file
+} // namespace cbl
@@ -0,0 +1,100 @@
+#include "ChunkGrid.hpp"
+
+#include <array>
+#include <utility>
+
+#include "Core/Profiler/Profiler.hpp"
+
+namespace cbl {
+void ChunkGrid::scheduleFacingBorders(int const &x, int const &y, int const &z) {
+  mPendingMeshes.scheduleFacingBorders(
+      x, y, z, [this](int const &neighbourX, int const &neighbourY, int const &neighbourZ) {
+        return mChunks.contains(neighbourX, neighbourY, neighbourZ);
+      });
+}
+
+Chunk &ChunkGrid::insert(int const &x, int const &y, int const &z, Chunk chunk) {
+  Chunk &inserted = mChunks.insert(x, y, z, std::move(chunk));
+
+  for (Block::Side const &side : Chunk::Sides) {
+    std::array<int, 3> const offset = Chunk::getOffset(side);
+    Chunk *neighbour = mChunks.find(x + offset[0], y + offset[1], z + offset[2]);
+    inserted.setNeighbour(side, neighbour);
+
+    if (neighbour != nullptr) {
+      neighbour->setNeighbour(Chunk::getOpposite(side), &inserted);
+    }
+  }
+
+  mPendingMeshes.schedule(x, y, z, Chunk::WholeMesh);
+  scheduleFacingBorders(x, y, z);
+
+  return inserted;
+}
+
+Chunk &ChunkGrid::insert(int const &x, int const &z, Chunk chunk) {
+  return insert(x, 0, z, std::move(chunk));
+}
+
+bool ChunkGrid::erase(int const &x, int const &y, int const &z) {
+  Chunk *chunk = mChunks.find(x, y, z);
+  if (chunk == nullptr) {
+    return false;
+  }
+
+  // the neighbours now face nothing, so their borders on that side become visible
+  for (Block::Side const &side : Chunk::Sides) {
+    Chunk *neighbour = chunk->getNeighbour(side);
+    if (neighbour != nullptr) {
+      neighbour->setNeighbour(Chunk::getOpposite(side), nullptr);
+    }
+  }
+
+  scheduleFacingBorders(x, y, z);
+  mPendingMeshes.cancel(x, y, z);
+  return mChunks.erase(x, y, z);
+}
+
+bool ChunkGrid::erase(int const &x, int const &z) { return erase(x, 0, z); }
+
+void ChunkGrid::clear() {
+  mChunks.clear();
+  mPendingMeshes.clear();
+}
+
+Chunk *ChunkGrid::find(int const &x, int const &y, int const &z) { return mChunks.find(x, y, z); }
+
+Chunk *ChunkGrid::find(int const &x, int const &z) { return mChunks.find(x, z); }
+
+Chunk const *ChunkGrid::find(int const &x, int const &y, int const &z) const {
+  return mChunks.find(x, y, z);
+}
+
+Chunk const *ChunkGrid::find(int const &x, int const &z) const { return mChunks.find(x, z); }
+
+Block::Type ChunkGrid::getBlock(int const &worldX, int const &worldY, int const &worldZ) const {
+  return mChunks.getBlock(worldX, worldY, worldZ);
+}
+
+std::size_t ChunkGrid::size() const { return mChunks.size(); }
+
+bool ChunkGrid::hasPendingMeshes() const { return !mPendingMeshes.empty(); }
+
+std::size_t ChunkGrid::rebuildMeshes() {
+  CBL_PROFILE_SCOPE("ChunkGrid::rebuildMeshes");
+
+  std::size_t rebuilt = 0;
+
+  mPendingMeshes.drain([this, &rebuilt](int const &x, int const &y, int const &z,
+                                        uint8_t const &parts) {
+    Chunk *chunk = mChunks.find(x, y, z);
+
+    if (chunk != nullptr) {
+      chunk->rebuild(parts);
+      rebuilt++;
+    }
+  });
+
+  return rebuilt;
+}
+} // namespace cbl
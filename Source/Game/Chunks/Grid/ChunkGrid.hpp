@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Game/Block/Block.hpp"
+#include "Game/Chunks/Chunk.hpp"
+#include "Game/Chunks/ChunkMap/ChunkMap.hpp"
+#include "Game/Chunks/RemeshQueue/ChunkRemeshQueue.hpp"
+
+namespace cbl {
+// chunks keyed by chunk coordinates that stay linked to their six neighbours as chunks are
+// inserted and erased
+// a new chunk needs its whole mesh built, the chunks around it only the border facing it, and
+// both are deferred to rebuildMeshes so a batch of inserts builds every mesh once
+struct ChunkGrid {
+private:
+  ChunkMap<Chunk> mChunks{};
+  ChunkRemeshQueue mPendingMeshes{};
+
+  // the borders facing (x, y, z) of the chunks around it
+  void scheduleFacingBorders(int const &x, int const &y, int const &z);
+
+public:
+  ChunkGrid() = default;
+  ChunkGrid(ChunkGrid const &) = delete;
+  ChunkGrid(ChunkGrid &&) noexcept = default;
+  ~ChunkGrid() = default;
+
+  void operator=(ChunkGrid const &) = delete;
+  ChunkGrid &operator=(ChunkGrid &&) noexcept = default;
+
+  // replaces the chunk at (x, y, z) if there is one, its neighbour pointers are overwritten
+  Chunk &insert(int const &x, int const &y, int const &z, Chunk chunk);
+  Chunk &insert(int const &x, int const &z, Chunk chunk);
+  bool erase(int const &x, int const &y, int const &z);
+  bool erase(int const &x, int const &z);
+  void clear();
+
+  [[nodiscard]] Chunk *find(int const &x, int const &y, int const &z);
+  [[nodiscard]] Chunk *find(int const &x, int const &z);
+  [[nodiscard]] Chunk const *find(int const &x, int const &y, int const &z) const;
+  [[nodiscard]] Chunk const *find(int const &x, int const &z) const;
+  // block at world coordinates, air where no chunk is loaded
+  [[nodiscard]] Block::Type getBlock(int const &worldX, int const &worldY,
+                                     int const &worldZ) const;
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] bool hasPendingMeshes() const;
+
+  // rebuilds the meshes and borders made stale by inserts and erases, returns how many chunks
+  // were touched
+  std::size_t rebuildMeshes();
+
+  // calls function(x, y, z, chunk) for every chunk, which must not insert or erase chunks
+  template <typename Function> void forEach(Function &&function);
+  template <typename Function> void forEach(Function &&function) const;
+};
+
+template <typename Function> void ChunkGrid::forEach(Function &&function) {
+  mChunks.forEach(function);
+}
+
+template <typename Function> void ChunkGrid::forEach(Function &&function) const {
+  mChunks.forEach(function);
+}
+} // namespace cbl
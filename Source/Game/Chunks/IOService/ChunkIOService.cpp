@@ -0,0 +1,489 @@
+#include "ChunkIOService.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "Core/Profiler/Profiler.hpp"
+
+namespace cbl {
+ChunkIOService::ChunkIOService(std::filesystem::path directory)
+    : mDirectory{std::move(directory)}, mBackend{IOBackend::create()} {
+  std::filesystem::create_directories(mDirectory);
+  mFreeBuffers.reserve(MaxFreeBuffers);
+  mThread = std::thread{&ChunkIOService::ioLoop, this};
+}
+
+ChunkIOService::~ChunkIOService() {
+  {
+    std::lock_guard<std::mutex> lock{mMutex};
+    mRunning = false;
+  }
+  mWake.notify_one();
+  mThread.join();
+
+  for (auto &[position, region] : mRegions) {
+    IOBackend::closeFile(region.fileDescriptor);
+  }
+}
+
+void ChunkIOService::ioLoop() {
+  Profiler::setThreadName("Chunk I/O thread");
+
+  std::vector<Request> requests{};
+  std::vector<IOCompletion> completions{};
+
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock{mMutex};
+
+      if (mBackend->getPendingCount() == 0) {
+        mWake.wait(lock, [this]() { return !mRunning || !mRequests.empty(); });
+
+        // queued saves are drained before stopping
+        if (!mRunning && mRequests.empty()) {
+          return;
+        }
+      }
+
+      requests.swap(mRequests);
+    }
+
+    bool const receivedRequests = !requests.empty();
+    submitRequests(requests);
+    requests.clear();
+
+    // with nothing new to submit, sleep until the disk answers
+    completions.clear();
+    mBackend->wait(completions, receivedRequests ? 0 : 1);
+
+    for (IOCompletion const &completion : completions) {
+      handleCompletion(completion);
+    }
+  }
+}
+
+ChunkIOService::OpenRegion &ChunkIOService::getRegion(int const &posX, int const &posZ) {
+  int const regionX = RegionFile::getRegionCoordinate(posX);
+  int const regionZ = RegionFile::getRegionCoordinate(posZ);
+
+  auto region = mRegions.find(std::make_pair(regionX, regionZ));
+  if (region == mRegions.end()) {
+    std::filesystem::path const path = mDirectory / RegionFile::getFileName(regionX, regionZ);
+    auto file = std::make_unique<RegionFile>(path);
+
+    OpenRegion opened{
+        std::move(file), IOBackend::openFile(path), nullptr, 0, false, false, {}, {}, {}};
+    region = mRegions.emplace(std::make_pair(regionX, regionZ), std::move(opened)).first;
+  }
+
+  return region->second;
+}
+
+void ChunkIOService::submitRequests(std::vector<Request> &requests) {
+  CBL_PROFILE_SCOPE("ChunkIOService::submitRequests");
+
+  std::vector<IORequest> ioRequests{};
+  ioRequests.reserve(requests.size());
+
+  for (Request &request : requests) {
+    OpenRegion &region = getRegion(request.posX, request.posZ);
+    int const localX = RegionFile::getLocalCoordinate(request.posX);
+    int const localZ = RegionFile::getLocalCoordinate(request.posZ);
+    auto const position = std::make_pair(request.posX, request.posZ);
+
+    if (request.type == Request::Type::eSave && mPendingSaves.count(position) != 0) {
+      std::vector<uint8_t> &deferredSave = mDeferredSaves[position];
+      recycleBuffer(std::move(deferredSave));
+      deferredSave = std::move(request.data);
+      continue;
+    }
+
+    if (request.type == Request::Type::eSave) {
+      uint64_t const requestId = mNextRequestId++;
+      std::optional<RegionFile::ChunkLocation> const previousLocation =
+          region.file->locate(localX, localZ);
+      uint64_t const offset =
+          region.file->allocate(localX, localZ, static_cast<uint32_t>(request.data.size()));
+      InFlight &write = mInFlight[requestId] = InFlight{InFlight::Type::eSaveData,
+                                                        request.posX,
+                                                        request.posZ,
+                                                        &region,
+                                                        std::move(request.data),
+                                                        offset,
+                                                        0,
+                                                        0,
+                                                        previousLocation};
+
+      region.pendingDataWrites++;
+      mPendingSaves[position] = requestId;
+
+      ioRequests.push_back(getRemainingTransfer(write, requestId));
+      continue;
+    }
+
+    // the latest save of this column may not have reached the disk yet
+    if (auto const deferredSave = mDeferredSaves.find(position);
+        deferredSave != mDeferredSaves.end()) {
+      ChunkLoadResult result{request.posX, request.posZ, ChunkLoadResult::Status::eLoaded,
+                             takeBuffer()};
+      result.data.assign(deferredSave->second.begin(), deferredSave->second.end());
+      pushResult(std::move(result));
+      continue;
+    }
+
+    if (auto const pendingSave = mPendingSaves.find(position); pendingSave != mPendingSaves.end()) {
+      std::vector<uint8_t> const &saved = mInFlight[pendingSave->second].buffer;
+      ChunkLoadResult result{request.posX, request.posZ, ChunkLoadResult::Status::eLoaded,
+                             takeBuffer()};
+      result.data.assign(saved.begin(), saved.end());
+      pushResult(std::move(result));
+      continue;
+    }
+
+    std::optional<RegionFile::ChunkLocation> const location = region.file->locate(localX, localZ);
+    if (!location) {
+      pushResult(
+          ChunkLoadResult{request.posX, request.posZ, ChunkLoadResult::Status::eMissing, {}});
+      continue;
+    }
+
+    // columns in the page cache are copied without a system call
+    ChunkLoadResult result{request.posX, request.posZ, ChunkLoadResult::Status::eLoaded,
+                           takeBuffer()};
+    if (readMapped(region, *location, result.data)) {
+      pushResult(std::move(result));
+      continue;
+    }
+
+    // read through the backend, which reports a file shorter than the table as a failed load
+    result.data.resize(location->byteSize);
+    uint64_t const requestId = mNextRequestId++;
+    InFlight &read = mInFlight[requestId] =
+        InFlight{InFlight::Type::eLoad,
+                 request.posX,
+                 request.posZ,
+                 &region,
+                 std::move(result.data),
+                 static_cast<uint64_t>(location->sectorOffset) * RegionFile::SectorSize,
+                 0,
+                 0,
+                 std::nullopt};
+
+    ioRequests.push_back(getRemainingTransfer(read, requestId));
+  }
+
+  // the whole batch goes to the backend at once, a single system call with io_uring
+  mBackend->submit(ioRequests);
+}
+
+bool ChunkIOService::readMapped(OpenRegion &region, RegionFile::ChunkLocation const &location,
+                                std::vector<uint8_t> &data) {
+  uint64_t const offset = static_cast<uint64_t>(location.sectorOffset) * RegionFile::SectorSize;
+  uint64_t const end = offset + location.byteSize;
+
+  // columns saved after the file was mapped can lie past the end of the mapping
+  if (region.mapping == nullptr || region.mapping->size() < end) {
+    try {
+      region.mapping = std::make_unique<MappedFile>(region.file->getPath());
+    } catch (std::runtime_error const &) {
+      region.mapping.reset();
+      return false;
+    }
+  }
+
+  if (region.mapping->size() < end) {
+    return false;
+  }
+
+  data.assign(region.mapping->data() + offset, region.mapping->data() + end);
+  return true;
+}
+
+void ChunkIOService::writeHeaderIfReady(OpenRegion &region, std::vector<IORequest> &ioRequests) {
+  // the table is only written once the data it points to is on disk, and one write at a time so
+  // an older table never lands after a newer one
+  if (!region.headerDirty || region.headerWriteInFlight || region.pendingDataWrites > 0) {
+    return;
+  }
+
+  // taken now, data written while the sync runs is not covered by it
+  region.header = region.file->serializeHeader();
+  region.headerReplacedLocations.swap(region.replacedLocations);
+  region.replacedLocations.clear();
+  region.headerDirty = false;
+  region.headerWriteInFlight = true;
+
+  uint64_t const requestId = mNextRequestId++;
+  InFlight &sync = mInFlight[requestId] =
+      InFlight{InFlight::Type::eSyncData, 0, 0, &region, {}, 0, 0, 0, std::nullopt};
+
+  ioRequests.push_back(getRemainingTransfer(sync, requestId));
+}
+
+void ChunkIOService::abortHeaderWrite(OpenRegion &region) {
+  region.headerWriteInFlight = false;
+  region.headerDirty = true;
+  region.header.clear();
+
+  region.replacedLocations.insert(region.replacedLocations.end(),
+                                  region.headerReplacedLocations.begin(),
+                                  region.headerReplacedLocations.end());
+  region.headerReplacedLocations.clear();
+}
+
+IORequest ChunkIOService::getRemainingTransfer(InFlight &inFlight, uint64_t const &requestId) {
+  IORequest::Type type = IORequest::Type::eWrite;
+  if (inFlight.type == InFlight::Type::eLoad) {
+    type = IORequest::Type::eRead;
+  } else if (inFlight.type == InFlight::Type::eSyncData ||
+             inFlight.type == InFlight::Type::eSyncHeader) {
+    type = IORequest::Type::eSync;
+  }
+
+  return IORequest{type,
+                   inFlight.region->fileDescriptor,
+                   inFlight.offset + inFlight.transferred,
+                   inFlight.buffer.data() + inFlight.transferred,
+                   static_cast<uint32_t>(inFlight.buffer.size()) - inFlight.transferred,
+                   requestId};
+}
+
+void ChunkIOService::handleCompletion(IOCompletion const &completion) {
+  auto const found = mInFlight.find(completion.userData);
+  if (found == mInFlight.end()) {
+    return;
+  }
+
+  std::vector<IORequest> followUps{};
+
+  // io_uring may transfer less than asked for, or give up on a busy or interrupted transfer
+  InFlight &transfer = found->second;
+  auto const remaining = static_cast<int64_t>(transfer.buffer.size() - transfer.transferred);
+  bool const interrupted = completion.result == -EAGAIN || completion.result == -EINTR;
+  if ((interrupted && transfer.retries < MaxRetries) ||
+      (completion.result > 0 && completion.result < remaining)) {
+    if (interrupted) {
+      transfer.retries++;
+    } else {
+      transfer.transferred += static_cast<uint32_t>(completion.result);
+    }
+
+    followUps.push_back(getRemainingTransfer(transfer, completion.userData));
+    mBackend->submit(followUps);
+    return;
+  }
+
+  // reads stopping at the end of the file are as much of a failure as errors
+  bool const succeeded = completion.result == remaining;
+
+  InFlight inFlight = std::move(found->second);
+  mInFlight.erase(found);
+
+  switch (inFlight.type) {
+  case InFlight::Type::eLoad: {
+    ChunkLoadResult result{inFlight.posX, inFlight.posZ, ChunkLoadResult::Status::eFailed, {}};
+    if (succeeded) {
+      result.status = ChunkLoadResult::Status::eLoaded;
+      result.data = std::move(inFlight.buffer);
+    } else {
+      recycleBuffer(std::move(inFlight.buffer));
+    }
+
+    pushResult(std::move(result));
+    break;
+  }
+  case InFlight::Type::eSaveData: {
+    auto const position = std::make_pair(inFlight.posX, inFlight.posZ);
+    if (auto const pendingSave = mPendingSaves.find(position);
+        pendingSave != mPendingSaves.end() && pendingSave->second == completion.userData) {
+      mPendingSaves.erase(pendingSave);
+    }
+
+    // the table keeps pointing at the previous copy unless the new one is fully written
+    if (succeeded) {
+      inFlight.region->headerDirty = true;
+      if (inFlight.previousLocation) {
+        inFlight.region->replacedLocations.push_back(*inFlight.previousLocation);
+      }
+    } else {
+      inFlight.region->file->restore(RegionFile::getLocalCoordinate(inFlight.posX),
+                                     RegionFile::getLocalCoordinate(inFlight.posZ),
+                                     inFlight.previousLocation);
+      // no header ever pointed at the new sectors
+      inFlight.region->file->release(RegionFile::ChunkLocation{
+          static_cast<uint32_t>(inFlight.offset / RegionFile::SectorSize),
+          static_cast<uint32_t>(inFlight.buffer.size())});
+    }
+
+    inFlight.region->pendingDataWrites--;
+    recycleBuffer(std::move(inFlight.buffer));
+
+    if (auto const deferredSave = mDeferredSaves.find(position);
+        deferredSave != mDeferredSaves.end()) {
+      std::vector<Request> requests{Request{Request::Type::eSave, inFlight.posX, inFlight.posZ,
+                                            std::move(deferredSave->second)}};
+      mDeferredSaves.erase(deferredSave);
+      submitRequests(requests);
+    }
+
+    writeHeaderIfReady(*inFlight.region, followUps);
+    break;
+  }
+  // a failed step leaves the header to be written again along with the next save
+  case InFlight::Type::eSyncData: {
+    if (!succeeded) {
+      abortHeaderWrite(*inFlight.region);
+      break;
+    }
+
+    uint64_t const requestId = mNextRequestId++;
+    InFlight &write = mInFlight[requestId] = InFlight{InFlight::Type::eSaveHeader,
+                                                      0,
+                                                      0,
+                                                      inFlight.region,
+                                                      std::move(inFlight.region->header),
+                                                      0,
+                                                      0,
+                                                      0,
+                                                      std::nullopt};
+    followUps.push_back(getRemainingTransfer(write, requestId));
+    break;
+  }
+  case InFlight::Type::eSaveHeader: {
+    if (!succeeded) {
+      abortHeaderWrite(*inFlight.region);
+      break;
+    }
+
+    uint64_t const requestId = mNextRequestId++;
+    InFlight &sync = mInFlight[requestId] =
+        InFlight{InFlight::Type::eSyncHeader, 0, 0, inFlight.region, {}, 0, 0, 0, std::nullopt};
+    followUps.push_back(getRemainingTransfer(sync, requestId));
+    break;
+  }
+  case InFlight::Type::eSyncHeader:
+    if (!succeeded) {
+      abortHeaderWrite(*inFlight.region);
+      break;
+    }
+
+    // nothing on disk points at the replaced copies anymore
+    for (RegionFile::ChunkLocation const &location : inFlight.region->headerReplacedLocations) {
+      inFlight.region->file->release(location);
+    }
+    inFlight.region->headerReplacedLocations.clear();
+    inFlight.region->headerWriteInFlight = false;
+
+    writeHeaderIfReady(*inFlight.region, followUps);
+    break;
+  }
+
+  if (!followUps.empty()) {
+    mBackend->submit(followUps);
+  }
+}
+
+void ChunkIOService::pushResult(ChunkLoadResult result) {
+  std::lock_guard<std::mutex> lock{mMutex};
+  mResults.push_back(std::move(result));
+}
+
+void ChunkIOService::requestLoad(int const &posX, int const &posZ) {
+  mKnownChunks.insert(posX, posZ, true);
+
+  {
+    std::lock_guard<std::mutex> lock{mMutex};
+    mRequests.push_back(Request{Request::Type::eLoad, posX, posZ, {}});
+  }
+  mWake.notify_one();
+}
+
+unsigned int ChunkIOService::requestRing(glm::vec3 const &cameraPosition, int const &radius) {
+  auto const centerX = static_cast<int>(std::floor(cameraPosition.x / Chunk::BlocksX));
+  auto const centerZ = static_cast<int>(std::floor(cameraPosition.z / Chunk::BlocksZ));
+
+  std::vector<std::pair<int, int>> &positions = mRingPositions;
+  positions.clear();
+  for (int x = centerX - radius; x <= centerX + radius; x++) {
+    for (int z = centerZ - radius; z <= centerZ + radius; z++) {
+      if (!mKnownChunks.contains(x, z)) {
+        positions.emplace_back(x, z);
+      }
+    }
+  }
+
+  if (positions.empty()) {
+    return 0;
+  }
+
+  std::sort(positions.begin(), positions.end(),
+            [centerX, centerZ](std::pair<int, int> const &a, std::pair<int, int> const &b) {
+              int const distanceA = (a.first - centerX) * (a.first - centerX) +
+                                    (a.second - centerZ) * (a.second - centerZ);
+              int const distanceB = (b.first - centerX) * (b.first - centerX) +
+                                    (b.second - centerZ) * (b.second - centerZ);
+              return distanceA < distanceB;
+            });
+
+  {
+    std::lock_guard<std::mutex> lock{mMutex};
+    for (std::pair<int, int> const &position : positions) {
+      mKnownChunks.insert(position.first, position.second, true);
+      mRequests.push_back(Request{Request::Type::eLoad, position.first, position.second, {}});
+    }
+  }
+  mWake.notify_one();
+
+  return static_cast<unsigned int>(positions.size());
+}
+
+void ChunkIOService::requestSave(int const &posX, int const &posZ, std::vector<uint8_t> data) {
+  {
+    std::lock_guard<std::mutex> lock{mMutex};
+    mRequests.push_back(Request{Request::Type::eSave, posX, posZ, std::move(data)});
+  }
+  mWake.notify_one();
+}
+
+void ChunkIOService::release(int const &posX, int const &posZ) {
+  mKnownChunks.erase(posX, posZ);
+}
+
+std::vector<uint8_t> ChunkIOService::takeBuffer() {
+  std::vector<uint8_t> buffer{};
+
+  {
+    std::lock_guard<std::mutex> lock{mMutex};
+    if (!mFreeBuffers.empty()) {
+      buffer = std::move(mFreeBuffers.back());
+      mFreeBuffers.pop_back();
+    }
+  }
+
+  buffer.clear();
+  return buffer;
+}
+
+void ChunkIOService::recycleBuffer(std::vector<uint8_t> buffer) {
+  if (buffer.capacity() == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock{mMutex};
+  if (mFreeBuffers.size() < MaxFreeBuffers) {
+    mFreeBuffers.push_back(std::move(buffer));
+  }
+}
+
+void ChunkIOService::poll(std::vector<ChunkLoadResult> &results) {
+  results.clear();
+
+  std::lock_guard<std::mutex> lock{mMutex};
+  results.swap(mResults);
+}
+
+char const *ChunkIOService::getBackendName() const { return mBackend->getName(); }
+} // namespace cbl
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Core/Files/IO/IOBackend.hpp"
+#include "Core/Files/MappedFile/MappedFile.hpp"
+#include "Game/Chunks/Chunk.hpp"
+#include "Game/Chunks/ChunkMap/ChunkMap.hpp"
+#include "Game/Chunks/Region/RegionFile.hpp"
+
+namespace cbl {
+struct ChunkLoadResult {
+  enum class Status {
+    eLoaded,
+    // not on disk yet, the column has to be generated
+    eMissing,
+    // on disk but the read failed, the column must not be generated and saved over it
+    eFailed
+  };
+
+  int posX;
+  int posZ;
+  Status status;
+  // the column as encoded by ChunkCodec::encodeColumn, decoded by the caller and then given back
+  // with ChunkIOService::recycleBuffer
+  std::vector<uint8_t> data;
+};
+
+// loads and saves chunk columns of a region file directory on a dedicated I/O thread
+// requests are queued without blocking and results are collected with poll
+// columns travel encoded, so the thread only moves bytes and empty sections cost nothing
+// loads are copied out of a mapping of the region file, saves go through the I/O backend
+struct ChunkIOService {
+private:
+  struct Request {
+    enum class Type { eLoad, eSave };
+
+    Type type;
+    int posX;
+    int posZ;
+    std::vector<uint8_t> data;
+  };
+
+  struct OpenRegion {
+    std::unique_ptr<RegionFile> file;
+    int fileDescriptor;
+    // remapped when a column lies past its end, null until the first load
+    std::unique_ptr<MappedFile> mapping;
+    unsigned int pendingDataWrites;
+    bool headerDirty;
+    bool headerWriteInFlight;
+    // copies replaced by newer saves, the header on disk may still point at them
+    std::vector<RegionFile::ChunkLocation> replacedLocations;
+    // the header being written and the copies it no longer points at, freed once it is on disk
+    std::vector<uint8_t> header;
+    std::vector<RegionFile::ChunkLocation> headerReplacedLocations;
+  };
+
+  struct InFlight {
+    // headers go through three steps: syncing the data they point to, the write, and its sync
+    enum class Type { eLoad, eSaveData, eSyncData, eSaveHeader, eSyncHeader };
+
+    Type type;
+    int posX;
+    int posZ;
+    OpenRegion *region;
+    std::vector<uint8_t> buffer;
+    uint64_t offset;
+    // short transfers are resubmitted for the rest of the buffer
+    uint32_t transferred;
+    unsigned int retries;
+    // where the column was before this save, put back if its data cannot be written
+    std::optional<RegionFile::ChunkLocation> previousLocation;
+  };
+
+  // attempts for a transfer interrupted without progress, with EAGAIN or EINTR
+  static constexpr unsigned int MaxRetries = 8;
+  // buffers kept for reuse, the others are freed
+  static constexpr std::size_t MaxFreeBuffers = 256;
+
+  std::filesystem::path mDirectory;
+
+  // shared with the I/O thread
+  std::mutex mMutex;
+  std::condition_variable mWake;
+  std::vector<Request> mRequests;
+  std::vector<ChunkLoadResult> mResults;
+  // column buffers given back by the caller and by finished saves, they keep their capacity
+  std::vector<std::vector<uint8_t>> mFreeBuffers;
+  bool mRunning{true};
+
+  // caller side, columns requested or loaded until released
+  ChunkMap<bool> mKnownChunks;
+  // reused by requestRing
+  std::vector<std::pair<int, int>> mRingPositions;
+
+  // I/O thread side
+  std::unique_ptr<IOBackend> mBackend;
+  std::map<std::pair<int, int>, OpenRegion> mRegions;
+  std::unordered_map<uint64_t, InFlight> mInFlight;
+  // saves whose data is not on disk yet, loads of those columns are answered from memory
+  std::map<std::pair<int, int>, uint64_t> mPendingSaves;
+  // newer saves of a column wait for the previous one, so they land in the order they were made
+  std::map<std::pair<int, int>, std::vector<uint8_t>> mDeferredSaves;
+  uint64_t mNextRequestId{0};
+
+  std::thread mThread;
+
+  void ioLoop();
+  [[nodiscard]] OpenRegion &getRegion(int const &posX, int const &posZ);
+  void submitRequests(std::vector<Request> &requests);
+  // false if the file cannot be mapped or is shorter than the table says
+  [[nodiscard]] static bool readMapped(OpenRegion &region,
+                                       RegionFile::ChunkLocation const &location,
+                                       std::vector<uint8_t> &data);
+  void handleCompletion(IOCompletion const &completion);
+  // the part of the transfer that did not complete yet
+  [[nodiscard]] static IORequest getRemainingTransfer(InFlight &inFlight,
+                                                      uint64_t const &requestId);
+  void writeHeaderIfReady(OpenRegion &region, std::vector<IORequest> &ioRequests);
+  // the header is written again with the next save, the copies it replaces stay reserved
+  static void abortHeaderWrite(OpenRegion &region);
+  void pushResult(ChunkLoadResult result);
+
+public:
+  ChunkIOService() = delete;
+  explicit ChunkIOService(std::filesystem::path directory);
+  ChunkIOService(ChunkIOService const &) = delete;
+  // finishes every queued save before returning
+  ~ChunkIOService();
+
+  void operator=(ChunkIOService const &) = delete;
+
+  void requestLoad(int const &posX, int const &posZ);
+  // queues every column within radius of the camera that is not loaded yet as one batch, nearest
+  // first, and returns how many were queued
+  unsigned int requestRing(glm::vec3 const &cameraPosition, int const &radius);
+  // data is a column as encoded by ChunkCodec::encodeColumn
+  void requestSave(int const &posX, int const &posZ, std::vector<uint8_t> data);
+  // lets requestRing load the column again once it was unloaded
+  void release(int const &posX, int const &posZ);
+
+  // an empty buffer that keeps the capacity of one given back earlier, to encode a column into
+  // saved buffers come back once they are written, so encoding and loading reuse the same ones
+  [[nodiscard]] std::vector<uint8_t> takeBuffer();
+  // gives back a buffer that is not needed anymore, such as the data of a decoded load
+  void recycleBuffer(std::vector<uint8_t> buffer);
+
+  // replaces results with the loads finished since the last call, the vectors are swapped so both
+  // keep their capacity
+  void poll(std::vector<ChunkLoadResult> &results);
+  [[nodiscard]] char const *getBackendName() const;
+};
+} // namespace cbl
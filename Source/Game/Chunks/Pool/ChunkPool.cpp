@@ -0,0 +1,100 @@
+#include "ChunkPool.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace cbl {
+bool ChunkHandle::isValid() const { return index != NoIndex; }
+
+ChunkPool::ChunkPool(std::size_t const &capacity) {
+  while (getCapacity() < capacity) {
+    addPage();
+  }
+
+  mSpareMeshes.reserve(getCapacity());
+}
+
+void ChunkPool::addPage() {
+  auto const first = static_cast<uint32_t>(getCapacity());
+  mPages.push_back(std::make_unique<Slot[]>(PageSize));
+
+  // handed out from the back, so the lowest slots go first
+  mFreeSlots.reserve(getCapacity());
+  for (std::size_t i = PageSize; i > 0; i--) {
+    mFreeSlots.push_back(first + static_cast<uint32_t>(i - 1));
+  }
+}
+
+ChunkPool::Slot &ChunkPool::getSlot(ChunkHandle const &handle) const {
+  if (!handle.isValid() || handle.index >= getCapacity()) {
+    throw std::out_of_range("Chunk handle is outside of the pool");
+  }
+
+  Slot &slot = mPages[handle.index / PageSize][handle.index % PageSize];
+  if (!slot.used || slot.generation != handle.generation) {
+    throw std::logic_error("Chunk handle was already released");
+  }
+
+  return slot;
+}
+
+ChunkHandle ChunkPool::acquire() {
+  if (mFreeSlots.empty()) {
+    addPage();
+  }
+
+  uint32_t const index = mFreeSlots.back();
+  mFreeSlots.pop_back();
+
+  Slot &slot = mPages[index / PageSize][index % PageSize];
+  slot.used = true;
+  mUsedCount++;
+
+  return ChunkHandle{index, slot.generation};
+}
+
+void ChunkPool::release(ChunkHandle const &handle) {
+  Slot &slot = getSlot(handle);
+
+  slot.chunk.clearMesh();
+  slot.chunk.neighbourXPlus = nullptr;
+  slot.chunk.neighbourXMinus = nullptr;
+  slot.chunk.neighbourZPlus = nullptr;
+  slot.chunk.neighbourZMinus = nullptr;
+  slot.chunk.neighbourYPlus = nullptr;
+  slot.chunk.neighbourYMinus = nullptr;
+
+  slot.used = false;
+  slot.generation++;
+  mUsedCount--;
+  mFreeSlots.push_back(handle.index);
+}
+
+Chunk &ChunkPool::get(ChunkHandle const &handle) { return getSlot(handle).chunk; }
+
+Chunk const &ChunkPool::get(ChunkHandle const &handle) const { return getSlot(handle).chunk; }
+
+MeshData ChunkPool::takeMesh() {
+  if (mSpareMeshes.empty()) {
+    return MeshData{};
+  }
+
+  MeshData mesh = std::move(mSpareMeshes.back());
+  mSpareMeshes.pop_back();
+  return mesh;
+}
+
+void ChunkPool::recycleMesh(MeshData mesh) {
+  if (mesh.indices.capacity() == 0 && mesh.vertices.capacity() == 0) {
+    return;
+  }
+
+  mesh.indices.clear();
+  mesh.vertices.clear();
+  mSpareMeshes.push_back(std::move(mesh));
+}
+
+std::size_t ChunkPool::getCapacity() const { return mPages.size() * PageSize; }
+
+std::size_t ChunkPool::getUsedCount() const { return mUsedCount; }
+} // namespace cbl
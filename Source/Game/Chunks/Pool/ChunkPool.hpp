@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Game/Chunks/Chunk.hpp"
+#include "Game/MeshData/MeshData.hpp"
+
+namespace cbl {
+// chunk handed out by a ChunkPool, stale once the chunk was released
+struct ChunkHandle {
+  static constexpr uint32_t NoIndex = UINT32_MAX;
+
+  uint32_t index = NoIndex;
+  uint32_t generation = 0;
+
+  [[nodiscard]] bool isValid() const;
+};
+
+// chunks allocated in pages up front and recycled on release
+// released chunks and meshes keep the capacity of their vectors, so once the pool is warm
+// streaming chunks in and out only allocates when a mesh outgrows the recycled one it was given
+struct ChunkPool {
+private:
+  static constexpr std::size_t PageSize = 64;
+
+  struct Slot {
+    Chunk chunk{};
+    uint32_t generation = 0;
+    bool used = false;
+  };
+
+  std::vector<std::unique_ptr<Slot[]>> mPages{};
+  std::vector<uint32_t> mFreeSlots{};
+  std::vector<MeshData> mSpareMeshes{};
+  std::size_t mUsedCount{0};
+
+  void addPage();
+  [[nodiscard]] Slot &getSlot(ChunkHandle const &handle) const;
+
+public:
+  ChunkPool() = delete;
+  // preallocates at least capacity chunks, more pages are added when they run out
+  explicit ChunkPool(std::size_t const &capacity);
+  ChunkPool(ChunkPool const &) = delete;
+
+  void operator=(ChunkPool const &) = delete;
+
+  // unlinked chunk with an empty mesh, its blocks are left as the previous user left them
+  [[nodiscard]] ChunkHandle acquire();
+  void release(ChunkHandle const &handle);
+  [[nodiscard]] Chunk &get(ChunkHandle const &handle);
+  [[nodiscard]] Chunk const &get(ChunkHandle const &handle) const;
+
+  // empty mesh reusing the vectors of a recycled one when there is one
+  [[nodiscard]] MeshData takeMesh();
+  void recycleMesh(MeshData mesh);
+
+  [[nodiscard]] std::size_t getCapacity() const;
+  [[nodiscard]] std::size_t getUsedCount() const;
+};
+} // namespace cbl
@@ -0,0 +1,193 @@
+#include "RegionFile.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+namespace cbl {
+RegionFile::RegionFile(std::filesystem::path path) : mPath{std::move(path)} {
+  if (!std::filesystem::exists(mPath)) {
+    std::fstream file = openFile();
+    writeHeader(file);
+    return;
+  }
+
+  MappedFile const mapping{mPath};
+  if (mapping.size() < HeaderSize) {
+    throw std::runtime_error("Region file " + mPath.string() + " is truncated");
+  }
+
+  uint32_t magic;
+  uint32_t version;
+  std::memcpy(&magic, mapping.data(), sizeof(uint32_t));
+  std::memcpy(&version, mapping.data() + sizeof(uint32_t), sizeof(uint32_t));
+
+  if (magic != Magic || version != Version) {
+    throw std::runtime_error(mPath.string() + " is not a supported region file");
+  }
+
+  std::memcpy(mLocations.data(), mapping.data() + 2 * sizeof(uint32_t), sizeof(mLocations));
+  mSectorCount = std::max(
+      HeaderSectors, static_cast<uint32_t>((mapping.size() + SectorSize - 1) / SectorSize));
+
+  // the gaps between columns are left behind by columns that moved
+  std::vector<SectorRange> used{};
+  for (ChunkLocation const &location : mLocations) {
+    if (location.sectorOffset != 0) {
+      used.push_back(SectorRange{location.sectorOffset, getSectorCount(location.byteSize)});
+    }
+  }
+  std::sort(used.begin(), used.end(), [](SectorRange const &a, SectorRange const &b) {
+    return a.offset < b.offset;
+  });
+
+  uint32_t firstUnused = HeaderSectors;
+  for (SectorRange const &range : used) {
+    if (range.offset > firstUnused) {
+      addFreeSectors(SectorRange{firstUnused, range.offset - firstUnused});
+    }
+    firstUnused = std::max(firstUnused, range.offset + range.count);
+  }
+  if (mSectorCount > firstUnused) {
+    addFreeSectors(SectorRange{firstUnused, mSectorCount - firstUnused});
+  }
+}
+
+int RegionFile::getRegionCoordinate(int const &chunkCoordinate) {
+  // rounds towards negative infinity so chunk -1 lands in region -1
+  return chunkCoordinate / ChunksPerSide - (chunkCoordinate % ChunksPerSide < 0 ? 1 : 0);
+}
+
+int RegionFile::getLocalCoordinate(int const &chunkCoordinate) {
+  return chunkCoordinate - getRegionCoordinate(chunkCoordinate) * ChunksPerSide;
+}
+
+std::string RegionFile::getFileName(int const &regionX, int const &regionZ) {
+  return "r." + std::to_string(regionX) + "." + std::to_string(regionZ) + ".cbr";
+}
+
+std::size_t RegionFile::getLocationIndex(int const &localX, int const &localZ) {
+  if (localX < 0 || localX >= ChunksPerSide || localZ < 0 || localZ >= ChunksPerSide) {
+    throw std::out_of_range("Chunk is outside of the region");
+  }
+
+  return static_cast<std::size_t>(localX * ChunksPerSide + localZ);
+}
+
+uint32_t RegionFile::getSectorCount(uint32_t const &byteSize) {
+  return (byteSize + SectorSize - 1) / SectorSize;
+}
+
+void RegionFile::addFreeSectors(SectorRange const &range) {
+  if (range.count == 0) {
+    return;
+  }
+
+  auto next = std::lower_bound(mFreeSectors.begin(), mFreeSectors.end(), range.offset,
+                               [](SectorRange const &freeRange, uint32_t const &offset) {
+                                 return freeRange.offset < offset;
+                               });
+  next = mFreeSectors.insert(next, range);
+
+  // merges with the following range, then with the previous one
+  if (std::next(next) != mFreeSectors.end() &&
+      next->offset + next->count == std::next(next)->offset) {
+    next->count += std::next(next)->count;
+    mFreeSectors.erase(std::next(next));
+  }
+  if (next != mFreeSectors.begin() &&
+      std::prev(next)->offset + std::prev(next)->count == next->offset) {
+    std::prev(next)->count += next->count;
+    mFreeSectors.erase(next);
+  }
+}
+
+std::fstream RegionFile::openFile() const {
+  std::fstream file{mPath, std::ios::in | std::ios::out | std::ios::binary};
+
+  if (!file.is_open()) {
+    // in|out does not create missing files
+    file.open(mPath, std::ios::out | std::ios::binary);
+  }
+
+  if (!file.is_open()) {
+    throw std::runtime_error("Failed to open region file " + mPath.string());
+  }
+
+  return file;
+}
+
+void RegionFile::writeHeader(std::fstream &file) const {
+  std::vector<uint8_t> header = serializeHeader();
+  // pad the header to a whole sector so chunk data starts aligned
+  header.resize(HeaderSectors * SectorSize, 0);
+
+  file.seekp(0);
+  file.write(reinterpret_cast<char const *>(header.data()),
+             static_cast<std::streamsize>(header.size()));
+
+  if (!file) {
+    throw std::runtime_error("Failed to write region file " + mPath.string());
+  }
+}
+
+std::filesystem::path const &RegionFile::getPath() const { return mPath; }
+
+std::optional<RegionFile::ChunkLocation> RegionFile::locate(int const &localX,
+                                                            int const &localZ) const {
+  ChunkLocation const &location = mLocations[getLocationIndex(localX, localZ)];
+
+  // sector 0 holds the header, so no chunk can start there
+  if (location.sectorOffset == 0) {
+    return std::nullopt;
+  }
+
+  return location;
+}
+
+uint64_t RegionFile::allocate(int const &localX, int const &localZ, uint32_t const &byteSize) {
+  uint32_t const sectorsNeeded = getSectorCount(byteSize);
+  ChunkLocation &location = mLocations[getLocationIndex(localX, localZ)];
+
+  // never the sectors of the previous copy, a torn write must leave it intact
+  auto const freeRange = std::find_if(
+      mFreeSectors.begin(), mFreeSectors.end(),
+      [sectorsNeeded](SectorRange const &range) { return range.count >= sectorsNeeded; });
+
+  if (freeRange != mFreeSectors.end()) {
+    location.sectorOffset = freeRange->offset;
+    freeRange->offset += sectorsNeeded;
+    freeRange->count -= sectorsNeeded;
+    if (freeRange->count == 0) {
+      mFreeSectors.erase(freeRange);
+    }
+  } else {
+    location.sectorOffset = mSectorCount;
+    mSectorCount += sectorsNeeded;
+  }
+  location.byteSize = byteSize;
+
+  return static_cast<uint64_t>(location.sectorOffset) * SectorSize;
+}
+
+void RegionFile::restore(int const &localX, int const &localZ,
+                         std::optional<ChunkLocation> const &location) {
+  mLocations[getLocationIndex(localX, localZ)] = location.value_or(ChunkLocation{0, 0});
+}
+
+void RegionFile::release(ChunkLocation const &location) {
+  addFreeSectors(SectorRange{location.sectorOffset, getSectorCount(location.byteSize)});
+}
+
+std::vector<uint8_t> RegionFile::serializeHeader() const {
+  std::vector<uint8_t> header(HeaderSize);
+
+  std::memcpy(header.data(), &Magic, sizeof(uint32_t));
+  std::memcpy(header.data() + sizeof(uint32_t), &Version, sizeof(uint32_t));
+  std::memcpy(header.data() + 2 * sizeof(uint32_t), mLocations.data(), sizeof(mLocations));
+
+  return header;
+}
+} // namespace cbl
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Core/Files/MappedFile/MappedFile.hpp"
+
+namespace cbl {
+// 32x32 chunk columns stored in 4 KiB sectors behind an offset table
+// each column is kept as encoded by ChunkCodec::encodeColumn, the data itself is read and written
+// by ChunkIOService
+struct RegionFile {
+public:
+  static constexpr int ChunksPerSide = 32;
+  static constexpr uint32_t SectorSize = 4096;
+
+  struct ChunkLocation {
+    uint32_t sectorOffset;
+    uint32_t byteSize;
+  };
+  static_assert(sizeof(ChunkLocation) == 8, "Chunk locations are written as is");
+
+private:
+  static constexpr uint32_t Magic = 0x47524243; // "CBRG"
+  static constexpr uint32_t Version = 3;
+  static constexpr std::size_t HeaderSize =
+      2 * sizeof(uint32_t) + ChunksPerSide * ChunksPerSide * sizeof(ChunkLocation);
+  static constexpr uint32_t HeaderSectors = (HeaderSize + SectorSize - 1) / SectorSize;
+
+  struct SectorRange {
+    uint32_t offset;
+    uint32_t count;
+  };
+
+  std::filesystem::path mPath;
+  std::array<ChunkLocation, ChunksPerSide * ChunksPerSide> mLocations{};
+  uint32_t mSectorCount{HeaderSectors};
+  // sectors no column uses, sorted by offset and never adjacent
+  std::vector<SectorRange> mFreeSectors;
+
+  [[nodiscard]] static std::size_t getLocationIndex(int const &localX, int const &localZ);
+  [[nodiscard]] static uint32_t getSectorCount(uint32_t const &byteSize);
+  void addFreeSectors(SectorRange const &range);
+  [[nodiscard]] std::fstream openFile() const;
+  void writeHeader(std::fstream &file) const;
+
+public:
+  RegionFile() = delete;
+  // region holding a chunk coordinate, and the chunk's coordinate inside of it
+  [[nodiscard]] static int getRegionCoordinate(int const &chunkCoordinate);
+  [[nodiscard]] static int getLocalCoordinate(int const &chunkCoordinate);
+  [[nodiscard]] static std::string getFileName(int const &regionX, int const &regionZ);
+
+  // opens the region file at path, creating an empty one if it does not exist
+  explicit RegionFile(std::filesystem::path path);
+  RegionFile(RegionFile const &) = delete;
+  ~RegionFile() = default;
+
+  void operator=(RegionFile const &) = delete;
+
+  [[nodiscard]] std::filesystem::path const &getPath() const;
+  [[nodiscard]] std::optional<ChunkLocation> locate(int const &localX, int const &localZ) const;
+  // reserves fresh sectors for byteSize bytes of column data and returns their byte offset in the
+  // file, the sectors of the previous copy stay reserved until they are released
+  [[nodiscard]] uint64_t allocate(int const &localX, int const &localZ, uint32_t const &byteSize);
+  // puts back a location returned by locate, for data that never made it to the disk
+  void restore(int const &localX, int const &localZ,
+               std::optional<ChunkLocation> const &location);
+  // lets allocate reuse the sectors, once no header on disk points at them anymore
+  void release(ChunkLocation const &location);
+  [[nodiscard]] std::vector<uint8_t> serializeHeader() const;
+};
+} // namespace cbl
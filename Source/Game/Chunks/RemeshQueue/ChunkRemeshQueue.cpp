@@ -0,0 +1,20 @@
+#include "ChunkRemeshQueue.hpp"
+
+namespace cbl {
+void ChunkRemeshQueue::schedule(int const &x, int const &y, int const &z, uint8_t const &parts) {
+  uint8_t *pending = mPending.find(x, y, z);
+  if (pending == nullptr) {
+    mPending.insert(x, y, z, parts);
+  } else {
+    *pending |= parts;
+  }
+}
+
+void ChunkRemeshQueue::cancel(int const &x, int const &y, int const &z) {
+  mPending.erase(x, y, z);
+}
+
+void ChunkRemeshQueue::clear() { mPending.clear(); }
+
+bool ChunkRemeshQueue::empty() const { return mPending.empty(); }
+} // namespace cbl
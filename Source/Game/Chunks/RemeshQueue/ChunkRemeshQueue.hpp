@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "Game/Block/Block.hpp"
+#include "Game/Chunks/Chunk.hpp"
+#include "Game/Chunks/ChunkMap/ChunkMap.hpp"
+
+namespace cbl {
+// chunks waiting for their mesh or some of its borders to be rebuilt, merged so a batch of changes
+// rebuilds every chunk once
+// a chunk that appeared, changed or went away needs the border of each neighbour that faces it
+// rebuilt, which scheduleFacingBorders does the same way for every owner of chunks
+struct ChunkRemeshQueue {
+private:
+  // parts to rebuild, as taken by Chunk::rebuild
+  ChunkMap<uint8_t> mPending{};
+
+public:
+  ChunkRemeshQueue() = default;
+  ChunkRemeshQueue(ChunkRemeshQueue const &) = delete;
+  ChunkRemeshQueue(ChunkRemeshQueue &&) noexcept = default;
+  ~ChunkRemeshQueue() = default;
+
+  void operator=(ChunkRemeshQueue const &) = delete;
+  ChunkRemeshQueue &operator=(ChunkRemeshQueue &&) noexcept = default;
+
+  void schedule(int const &x, int const &y, int const &z, uint8_t const &parts);
+  // schedules the border facing (x, y, z) of every neighbour for which hasNeighbour(x, y, z) is
+  // true
+  template <typename HasNeighbour>
+  void scheduleFacingBorders(int const &x, int const &y, int const &z,
+                             HasNeighbour &&hasNeighbour);
+  void cancel(int const &x, int const &y, int const &z);
+  void clear();
+
+  [[nodiscard]] bool empty() const;
+
+  // calls function(x, y, z, parts) for every scheduled chunk and empties the queue
+  template <typename Function> void drain(Function &&function);
+};
+
+template <typename HasNeighbour>
+void ChunkRemeshQueue::scheduleFacingBorders(int const &x, int const &y, int const &z,
+                                             HasNeighbour &&hasNeighbour) {
+  for (Block::Side const &side : Chunk::Sides) {
+    std::array<int, 3> const offset = Chunk::getOffset(side);
+    int const neighbourX = x + offset[0];
+    int const neighbourY = y + offset[1];
+    int const neighbourZ = z + offset[2];
+
+    if (hasNeighbour(neighbourX, neighbourY, neighbourZ)) {
+      schedule(neighbourX, neighbourY, neighbourZ, Chunk::getSideBit(Chunk::getOpposite(side)));
+    }
+  }
+}
+
+template <typename Function> void ChunkRemeshQueue::drain(Function &&function) {
+  mPending.forEach([this, &function](int const &x, int const &y, int const &z,
+                                     uint8_t const &parts) {
+    function(x, y, z, parts);
+    mPending.erase(x, y, z);
+  });
+}
+} // namespace cbl
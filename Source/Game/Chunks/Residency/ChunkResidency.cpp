@@ -0,0 +1,650 @@
+#include "ChunkResidency.hpp"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#include "Core/Memory/AllocationTracker/AllocationTracker.hpp"
+#include "Core/Profiler/Profiler.hpp"
+#include "Game/Chunks/Codec/ChunkCodec.hpp"
+#include "Game/Chunks/Generator/ChunkGenerator.hpp"
+
+namespace cbl {
+namespace {
+int getDistance(std::pair<int, int> const &position, int const &cameraX, int const &cameraZ) {
+  return std::max(std::abs(position.first - cameraX), std::abs(position.second - cameraZ));
+}
+
+// every column within the resident radius
+std::size_t getResidentCount(ChunkResidencySettings const &settings) {
+  auto const side = static_cast<std::size_t>(2 * std::max(settings.residentRadius, 0) + 1);
+  return side * side;
+}
+
+// sections with a chunk of their own in every column within the resident radius
+std::size_t getResidentSections(ChunkResidencySettings const &settings) {
+  return getResidentCount(settings) * settings.sectionsPerColumn;
+}
+
+bool isAll(Chunk::Blocks const &blocks, Block::Type const &type) {
+  for (auto const &plane : blocks) {
+    for (auto const &row : plane) {
+      for (Block::Type const &block : row) {
+        if (block != type) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+} // namespace
+
+ChunkResidency::ChunkResidency(ChunkIOService &chunkIO, ChunkResidencySettings const &settings)
+    : mChunkIO{chunkIO}, mSettings{settings}, mPool{getResidentSections(settings)} {
+  std::size_t const residentCount = getResidentCount(settings);
+  std::size_t const residentSections = getResidentSections(settings);
+  mRemeshedChunks.reserve(residentSections);
+  mEvictedChunks.reserve(residentCount);
+  mLoadResults.reserve(residentCount);
+  mChangedChunks.reserve(residentSections);
+  mBudgetCandidates.reserve(residentCount);
+  // a section and its neighbours
+  mScratchSections.reserve(Chunk::Sides.size() + 1);
+
+  for (auto &plane : mBuriedSection.blocks) {
+    for (auto &row : plane) {
+      row.fill(BuriedBlock);
+    }
+  }
+}
+
+ChunkResidency::~ChunkResidency() {
+  mEntries.forEach([this](int const &posX, int const &, int const &posZ, Entry &entry) {
+    if (entry.dirty && entry.tier != Tier::eCold) {
+      evict(std::make_pair(posX, posZ), entry);
+    }
+  });
+}
+
+std::size_t ChunkResidency::getEntryBytes(Entry const &entry) const {
+  switch (entry.tier) {
+  case Tier::eHot: {
+    std::size_t bytes = 0;
+    for (ChunkHandle const &section : entry.sections) {
+      if (section.isValid()) {
+        bytes += sizeof(Chunk) + mPool.get(section).getReservedMeshSize();
+      }
+    }
+    return bytes;
+  }
+  case Tier::eWarm:
+    return entry.compressed.capacity();
+  case Tier::eCold:
+    break;
+  }
+
+  return 0;
+}
+
+void ChunkResidency::receiveLoads() {
+  if (mNextLoadResult == mLoadResults.size()) {
+    mChunkIO.poll(mLoadResults);
+    mNextLoadResult = 0;
+  }
+  mChangedChunks.clear();
+
+  std::size_t const end = std::min(mLoadResults.size(), mNextLoadResult + mSettings.loadsPerStep);
+  for (; mNextLoadResult < end; mNextLoadResult++) {
+    ChunkLoadResult &result = mLoadResults[mNextLoadResult];
+    mPendingLoads = mPendingLoads > 0 ? mPendingLoads - 1 : 0;
+
+    auto const position = std::make_pair(result.posX, result.posZ);
+    Entry *previous = mEntries.find(result.posX, result.posZ);
+    if (previous != nullptr) {
+      releaseSections(*previous);
+    }
+
+    // the column stays cold, generating it would replace the copy on disk with the next save
+    // an access requests it again
+    if (result.status == ChunkLoadResult::Status::eFailed) {
+      mEntries.insert(result.posX, result.posZ,
+                      Entry{Tier::eCold, {}, 0, {}, mStep, false, false});
+      continue;
+    }
+
+    Entry entry{Tier::eHot, {}, 0, {}, mStep, false, false};
+
+    // columns missing or corrupted on disk are generated once and saved right away
+    if (result.status == ChunkLoadResult::Status::eMissing ||
+        !decodeColumn(position, result.data.data(), result.data.size(), entry)) {
+      generateColumn(position, entry);
+
+      std::vector<uint8_t> data = mChunkIO.takeBuffer();
+      encodeColumn(entry, data);
+      mChunkIO.requestSave(result.posX, result.posZ, std::move(data));
+    }
+    mChunkIO.recycleBuffer(std::move(result.data));
+
+    Entry const &inserted = mEntries.insert(result.posX, result.posZ, std::move(entry));
+
+    // buried sections are meshed as well when they face lower terrain next to them, the others
+    // only have the borders of their neighbours rebuilt
+    for (int y = 0; y < static_cast<int>(Chunk::ColumnSections); y++) {
+      std::array<int, 3> const section{result.posX, y, result.posZ};
+      if (inserted.sections[y].isValid() || (isBuried(inserted, y) && !isHidden(section))) {
+        mChangedChunks.push_back(section);
+      } else if (isBuried(inserted, y)) {
+        scheduleFacingBorders(section);
+      }
+    }
+  }
+
+  remeshChangedChunks();
+}
+
+void ChunkResidency::generateColumn(std::pair<int, int> const &position, Entry &entry) {
+  ChunkGenerator::Heightmap const heightmap =
+      ChunkGenerator::generateHeightmap(position.first, position.second, mSettings.seed);
+
+  int lowestSurface = INT_MAX;
+  for (auto const &row : heightmap) {
+    lowestSurface = std::min(lowestSurface, *std::min_element(row.begin(), row.end()));
+  }
+
+  for (int y = 0; y <= ChunkGenerator::getTopSection(heightmap); y++) {
+    // everything below the surface is BuriedBlock
+    if ((y + 1) * static_cast<int>(Chunk::BlocksY) <= lowestSurface) {
+      entry.buried |= static_cast<ChunkCodec::SectionMask>(1u << y);
+      continue;
+    }
+
+    ChunkHandle const handle = mPool.acquire();
+    ChunkGenerator::fill(mPool.get(handle), heightmap, position.first, y, position.second);
+    entry.sections[y] = handle;
+  }
+}
+
+bool ChunkResidency::decodeColumn(std::pair<int, int> const &position, uint8_t const *data,
+                                  std::size_t const &size, Entry &entry) {
+  bool const decoded =
+      ChunkCodec::decodeColumn(data, size, [this, &entry](int const &y) -> Chunk::Blocks & {
+        entry.sections[y] = mPool.acquire();
+        return mPool.get(entry.sections[y]).blocks;
+      });
+
+  if (!decoded) {
+    releaseSections(entry);
+    return false;
+  }
+
+  for (int y = 0; y < static_cast<int>(Chunk::ColumnSections); y++) {
+    if (!entry.sections[y].isValid()) {
+      continue;
+    }
+
+    if (isAll(mPool.get(entry.sections[y]).blocks, BuriedBlock)) {
+      mPool.release(entry.sections[y]);
+      entry.sections[y] = {};
+      entry.buried |= static_cast<ChunkCodec::SectionMask>(1u << y);
+    } else {
+      mPool.get(entry.sections[y]).placeAt(position.first, y, position.second);
+    }
+  }
+
+  return true;
+}
+
+void ChunkResidency::encodeColumn(Entry const &entry, std::vector<uint8_t> &output) const {
+  // sections emptied by edits are left out as well
+  std::array<Chunk::Blocks const *, Chunk::ColumnSections> sections{};
+  for (std::size_t y = 0; y < sections.size(); y++) {
+    if (isBuried(entry, static_cast<int>(y))) {
+      sections[y] = &mBuriedSection.blocks;
+    } else if (entry.sections[y].isValid()) {
+      Chunk const &section = mPool.get(entry.sections[y]);
+      sections[y] = section.isEmpty() ? nullptr : &section.blocks;
+    }
+  }
+
+  ChunkCodec::encodeColumn(sections, output);
+}
+
+void ChunkResidency::releaseSections(Entry &entry) {
+  for (ChunkHandle &section : entry.sections) {
+    if (section.isValid()) {
+      mPool.release(section);
+      section = {};
+    }
+  }
+
+  entry.buried = 0;
+}
+
+bool ChunkResidency::isBuried(Entry const &entry, int const &posY) {
+  return (entry.buried & (1u << posY)) != 0;
+}
+
+Chunk *ChunkResidency::getDense(std::array<int, 3> const &position) {
+  if (position[1] < 0 || position[1] >= static_cast<int>(Chunk::ColumnSections)) {
+    return nullptr;
+  }
+
+  Entry *entry = mEntries.find(position[0], position[2]);
+  if (entry == nullptr) {
+    return nullptr;
+  }
+
+  if (entry->tier == Tier::eWarm) {
+    Chunk &section = addScratchSection(position);
+    bool const decoded = ChunkCodec::decodeSection(
+        entry->compressed.data(), entry->compressed.size(), position[1], section.blocks);
+    if (decoded && !isAll(section.blocks, BuriedBlock)) {
+      return &section;
+    }
+
+    mPool.release(mScratchSections.back());
+    mScratchSections.pop_back();
+    return decoded ? &mBuriedSection : nullptr;
+  }
+
+  if (entry->tier != Tier::eHot) {
+    return nullptr;
+  }
+
+  if (isBuried(*entry, position[1])) {
+    return &mBuriedSection;
+  }
+
+  ChunkHandle const &section = entry->sections[position[1]];
+  return section.isValid() ? &mPool.get(section) : nullptr;
+}
+
+Chunk &ChunkResidency::addScratchSection(std::array<int, 3> const &position) {
+  mScratchSections.push_back(mPool.acquire());
+  Chunk &section = mPool.get(mScratchSections.back());
+  section.placeAt(position[0], position[1], position[2]);
+  return section;
+}
+
+void ChunkResidency::releaseScratchSections() {
+  for (ChunkHandle const &section : mScratchSections) {
+    mPool.release(section);
+  }
+  mScratchSections.clear();
+}
+
+bool ChunkResidency::isHidden(std::array<int, 3> const &position) {
+  bool hidden = true;
+  for (Block::Side const &side : Chunk::Sides) {
+    std::array<int, 3> const offset = Chunk::getOffset(side);
+    std::array<int, 3> const next{position[0] + offset[0], position[1] + offset[1],
+                                  position[2] + offset[2]};
+
+    // nothing is ever seen from below the world
+    if (next[1] < 0) {
+      continue;
+    }
+
+    // faces towards columns that are not loaded are kept, as everywhere else
+    Chunk const *neighbour = getDense(next);
+    if (neighbour == nullptr || (neighbour != &mBuriedSection && !neighbour->isSolid())) {
+      hidden = false;
+      break;
+    }
+  }
+
+  releaseScratchSections();
+  return hidden;
+}
+
+Chunk &ChunkResidency::materialize(std::array<int, 3> const &position, Entry &entry) {
+  ChunkHandle const handle = mPool.acquire();
+  Chunk &section = mPool.get(handle);
+  section.blocks = mBuriedSection.blocks;
+  section.placeAt(position[0], position[1], position[2]);
+
+  entry.sections[position[1]] = handle;
+  entry.buried &= static_cast<ChunkCodec::SectionMask>(~(1u << position[1]));
+
+  return section;
+}
+
+void ChunkResidency::remesh(std::array<int, 3> const &position, uint8_t const &parts) {
+  Chunk *chunk = getDense(position);
+  if (chunk == nullptr) {
+    return;
+  }
+
+  // a buried section is meshed in a chunk of its own, which it only keeps if a face is visible
+  Entry &entry = *mEntries.find(position[0], position[2]);
+  bool const hot = entry.tier == Tier::eHot;
+  bool const buried = chunk == &mBuriedSection;
+  // buried sections of hot columns never keep a mesh, those of warm columns may have been meshed
+  // while a neighbour was missing
+  if (buried && isHidden(position)) {
+    if (!hot) {
+      mRemeshedChunks.push_back(RemeshedChunk{position[0], position[1], position[2], MeshData{}});
+    }
+    return;
+  }
+  if (buried && hot) {
+    chunk = &materialize(position, entry);
+  } else if (buried) {
+    chunk = &addScratchSection(position);
+    chunk->blocks = mBuriedSection.blocks;
+  }
+
+  // only the borders being rebuilt need their neighbour, so the others can stay compressed
+  bool const whole = (parts & Chunk::WholeMesh) != 0 || !chunk->isMeshBuilt();
+  for (Block::Side const &side : Chunk::Sides) {
+    std::array<int, 3> const offset = Chunk::getOffset(side);
+    if (whole || (parts & Chunk::getSideBit(side)) != 0) {
+      chunk->setNeighbour(side, getDense({position[0] + offset[0], position[1] + offset[1],
+                                          position[2] + offset[2]}));
+    }
+  }
+
+  // the mesh only passes through the chunk, the parts it is assembled from stay
+  chunk->mesh = mPool.takeMesh();
+  chunk->placeAt(position[0], position[1], position[2]);
+  chunk->rebuild(parts);
+
+  // neighbours may be compressed or dropped later on, so the links only live for the rebuild
+  for (Block::Side const &side : Chunk::Sides) {
+    chunk->setNeighbour(side, nullptr);
+  }
+
+  bool const visible = !chunk->mesh.indices.empty();
+  mRemeshedChunks.push_back(
+      RemeshedChunk{position[0], position[1], position[2], std::move(chunk->mesh)});
+  chunk->mesh = MeshData{};
+
+  // sections that became invisible go back to being buried, such as those at the edge of the
+  // loaded area once the column next to them arrives
+  if (hot && !visible && (buried || isAll(chunk->blocks, BuriedBlock))) {
+    mPool.release(entry.sections[position[1]]);
+    entry.sections[position[1]] = {};
+    entry.buried |= static_cast<ChunkCodec::SectionMask>(1u << position[1]);
+  }
+
+  releaseScratchSections();
+}
+
+void ChunkResidency::scheduleFacingBorders(std::array<int, 3> const &position) {
+  mPendingMeshes.scheduleFacingBorders(
+      position[0], position[1], position[2],
+      [this](int const &posX, int const &posY, int const &posZ) {
+        return posY >= 0 && posY < static_cast<int>(Chunk::ColumnSections) &&
+               getTier(posX, posZ) != Tier::eCold;
+      });
+}
+
+void ChunkResidency::remeshChangedChunks() {
+  for (std::array<int, 3> const &position : mChangedChunks) {
+    mPendingMeshes.schedule(position[0], position[1], position[2], Chunk::WholeMesh);
+    scheduleFacingBorders(position);
+  }
+
+  mPendingMeshes.drain([this](int const &posX, int const &posY, int const &posZ,
+                              uint8_t const &parts) { remesh({posX, posY, posZ}, parts); });
+}
+
+void ChunkResidency::compress(Entry &entry) {
+  CBL_PROFILE_SCOPE("ChunkResidency::compress");
+
+  // the buffer is one the I/O service recycled, so its capacity is counted as it is
+  entry.compressed = mChunkIO.takeBuffer();
+  encodeColumn(entry, entry.compressed);
+
+  releaseSections(entry);
+  entry.tier = Tier::eWarm;
+}
+
+void ChunkResidency::decompress(std::pair<int, int> const &position, Entry &entry) {
+  CBL_PROFILE_SCOPE("ChunkResidency::decompress");
+
+  if (!decodeColumn(position, entry.compressed.data(), entry.compressed.size(), entry)) {
+    throw std::runtime_error("Compressed chunk column is corrupted");
+  }
+
+  mChunkIO.recycleBuffer(std::move(entry.compressed));
+  entry.compressed = {};
+  entry.tier = Tier::eHot;
+}
+
+void ChunkResidency::evict(std::pair<int, int> const &position, Entry &entry) {
+  ChunkCodec::SectionMask sections = entry.buried;
+  if (entry.tier == Tier::eHot) {
+    for (unsigned int y = 0; y < Chunk::ColumnSections; y++) {
+      sections |= entry.sections[y].isValid() ? static_cast<ChunkCodec::SectionMask>(1u << y) : 0;
+    }
+  } else if (entry.tier == Tier::eWarm) {
+    sections = ChunkCodec::getColumnSections(entry.compressed.data(), entry.compressed.size());
+  }
+
+  if (entry.dirty) {
+    // warm columns are already encoded the way they are saved
+    std::vector<uint8_t> data = std::move(entry.compressed);
+    if (entry.tier == Tier::eHot) {
+      data = mChunkIO.takeBuffer();
+      encodeColumn(entry, data);
+    }
+    mChunkIO.requestSave(position.first, position.second, std::move(data));
+  }
+
+  releaseSections(entry);
+  mChunkIO.recycleBuffer(std::move(entry.compressed));
+  entry.compressed = {};
+  entry.tier = Tier::eCold;
+  entry.dirty = false;
+  entry.loadRequested = false;
+
+  // the sections around the column face nothing now, rebuilt with the next remesh
+  for (unsigned int y = 0; y < Chunk::ColumnSections; y++) {
+    if ((sections & (1u << y)) != 0) {
+      scheduleFacingBorders({position.first, static_cast<int>(y), position.second});
+    }
+  }
+}
+
+void ChunkResidency::enforceBudget(int const &cameraX, int const &cameraZ) {
+  std::size_t usage = getMemoryUsage();
+  if (usage <= mSettings.memoryBudget) {
+    return;
+  }
+
+  // least recently used first, then furthest from the camera, never inside the hot radius
+  std::vector<std::pair<int, int>> &candidates = mBudgetCandidates;
+  candidates.clear();
+  mEntries.forEach([&](int const &posX, int const &, int const &posZ, Entry const &entry) {
+    auto const position = std::make_pair(posX, posZ);
+    if (entry.tier != Tier::eCold &&
+        getDistance(position, cameraX, cameraZ) > mSettings.hotRadius) {
+      candidates.push_back(position);
+    }
+  });
+
+  std::sort(candidates.begin(), candidates.end(),
+            [this, cameraX, cameraZ](std::pair<int, int> const &a, std::pair<int, int> const &b) {
+              Entry const &entryA = *mEntries.find(a.first, a.second);
+              Entry const &entryB = *mEntries.find(b.first, b.second);
+              if (entryA.lastAccess != entryB.lastAccess) {
+                return entryA.lastAccess < entryB.lastAccess;
+              }
+              return getDistance(a, cameraX, cameraZ) > getDistance(b, cameraX, cameraZ);
+            });
+
+  // compressing is cheap to undo, so it goes first and chunks only leave memory as a last resort
+  for (std::pair<int, int> const &position : candidates) {
+    Entry &entry = *mEntries.find(position.first, position.second);
+    if (usage <= mSettings.memoryBudget) {
+      return;
+    }
+
+    if (entry.tier == Tier::eHot) {
+      usage -= getEntryBytes(entry);
+      compress(entry);
+      usage += getEntryBytes(entry);
+    }
+  }
+
+  // dropped like columns out of range, so their meshes go as well
+  // requestRing loads them again with the next update, as the most recently used columns
+  for (std::pair<int, int> const &position : candidates) {
+    Entry &entry = *mEntries.find(position.first, position.second);
+    if (usage <= mSettings.memoryBudget) {
+      return;
+    }
+
+    usage -= getEntryBytes(entry);
+    evict(position, entry);
+    mChunkIO.release(position.first, position.second);
+    mEvictedChunks.push_back(position);
+    mEntries.erase(position.first, position.second);
+  }
+}
+
+void ChunkResidency::update(glm::vec3 const &cameraPosition) {
+  CBL_PROFILE_SCOPE("ChunkResidency::update");
+  CBL_ALLOCATION_SCOPE("Chunk residency");
+
+  mStep++;
+  receiveLoads();
+
+  mPendingLoads += mChunkIO.requestRing(cameraPosition, mSettings.residentRadius);
+
+  auto const cameraX = static_cast<int>(std::floor(cameraPosition.x / Chunk::BlocksX));
+  auto const cameraZ = static_cast<int>(std::floor(cameraPosition.z / Chunk::BlocksZ));
+
+  mEntries.forEach([&](int const &posX, int const &, int const &posZ, Entry &entry) {
+    auto const position = std::make_pair(posX, posZ);
+    int const distance = getDistance(position, cameraX, cameraZ);
+
+    if (distance > mSettings.residentRadius) {
+      evict(position, entry);
+      mChunkIO.release(posX, posZ);
+      mEvictedChunks.push_back(position);
+      mEntries.erase(posX, posZ);
+      return;
+    }
+
+    if (entry.tier == Tier::eHot && distance > mSettings.hotRadius &&
+        mStep - entry.lastAccess > mSettings.warmAfterSteps) {
+      compress(entry);
+    }
+  });
+
+  enforceBudget(cameraX, cameraZ);
+
+  mChangedChunks.clear();
+  remeshChangedChunks();
+}
+
+void ChunkResidency::finishLoads() {
+  CBL_PROFILE_SCOPE("ChunkResidency::finishLoads");
+
+  while (mPendingLoads > 0) {
+    // results polled already are received right away, past the limit of a step
+    if (mNextLoadResult == mLoadResults.size()) {
+      std::this_thread::yield();
+    }
+    receiveLoads();
+  }
+}
+
+Chunk *ChunkResidency::acquire(int const &posX, int const &posY, int const &posZ) {
+  Entry *entry = mEntries.find(posX, posZ);
+  if (entry == nullptr || posY < 0 || posY >= static_cast<int>(Chunk::ColumnSections)) {
+    return nullptr;
+  }
+
+  entry->lastAccess = mStep;
+
+  if (entry->tier == Tier::eCold) {
+    if (!entry->loadRequested) {
+      entry->loadRequested = true;
+      mPendingLoads++;
+      mChunkIO.requestLoad(posX, posZ);
+    }
+    return nullptr;
+  }
+
+  // edits need the whole column, which counts as an access and stays hot until it is left alone
+  if (entry->tier == Tier::eWarm) {
+    decompress(std::make_pair(posX, posZ), *entry);
+  }
+
+  Chunk *chunk = getDense({posX, posY, posZ});
+  if (chunk == &mBuriedSection) {
+    return &materialize({posX, posY, posZ}, *entry);
+  }
+  if (chunk != nullptr) {
+    return chunk;
+  }
+
+  ChunkHandle const handle = mPool.acquire();
+  Chunk &section = mPool.get(handle);
+  for (auto &plane : section.blocks) {
+    for (auto &row : plane) {
+      row.fill(Block::Type::eAir);
+    }
+  }
+  section.placeAt(posX, posY, posZ);
+  entry->sections[posY] = handle;
+
+  return &section;
+}
+
+void ChunkResidency::markModified(int const &posX, int const &posY, int const &posZ) {
+  Entry *entry = mEntries.find(posX, posZ);
+  if (entry == nullptr || entry->tier == Tier::eCold) {
+    return;
+  }
+
+  entry->dirty = true;
+
+  mChangedChunks.clear();
+  mChangedChunks.push_back({posX, posY, posZ});
+  remeshChangedChunks();
+}
+
+void ChunkResidency::takeRemeshedChunks(std::vector<RemeshedChunk> &remeshedChunks) {
+  remeshedChunks.clear();
+  remeshedChunks.swap(mRemeshedChunks);
+}
+
+void ChunkResidency::takeEvictedChunks(std::vector<std::pair<int, int>> &evictedChunks) {
+  evictedChunks.clear();
+  evictedChunks.swap(mEvictedChunks);
+}
+
+void ChunkResidency::recycleMesh(MeshData mesh) { mPool.recycleMesh(std::move(mesh)); }
+
+ChunkResidency::Tier ChunkResidency::getTier(int const &posX, int const &posZ) const {
+  Entry const *entry = mEntries.find(posX, posZ);
+  return entry == nullptr ? Tier::eCold : entry->tier;
+}
+
+bool ChunkResidency::hasPendingLoads() const { return mPendingLoads > 0; }
+
+std::size_t ChunkResidency::getMemoryUsage() const {
+  std::size_t usage = 0;
+  mEntries.forEach([this, &usage](int const &, int const &, int const &, Entry const &entry) {
+    usage += getEntryBytes(entry);
+  });
+  return usage;
+}
+
+std::size_t ChunkResidency::getColumnCount(Tier const &tier) const {
+  std::size_t count = 0;
+  mEntries.forEach([&count, &tier](int const &, int const &, int const &, Entry const &entry) {
+    count += entry.tier == tier ? 1 : 0;
+  });
+  return count;
+}
+} // namespace cbl
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Game/Chunks/Chunk.hpp"
+#include "Game/Chunks/ChunkMap/ChunkMap.hpp"
+#include "Game/Chunks/Codec/ChunkCodec.hpp"
+#include "Game/Chunks/Generator/ChunkGenerator.hpp"
+#include "Game/Chunks/IOService/ChunkIOService.hpp"
+#include "Game/Chunks/Pool/ChunkPool.hpp"
+#include "Game/Chunks/RemeshQueue/ChunkRemeshQueue.hpp"
+
+namespace cbl {
+struct ChunkResidencySettings {
+  // columns this close to the camera, in chunks, always stay dense
+  int hotRadius = 3;
+  // columns further than this are saved if needed and dropped from memory
+  int residentRadius = 8;
+  // loaded columns decoded or generated and meshed per step, at least one, the others wait for the
+  // next steps so crossing into a new ring does not stall a single step
+  std::size_t loadsPerStep = 8;
+  // sections with a chunk of their own a resident column is expected to hold, which sizes the
+  // pool and the buffers up front, generated terrain mostly has its surface across two sections
+  std::size_t sectionsPerColumn = 2;
+  // simulation steps without access before a column outside the hot radius is compressed
+  unsigned int warmAfterSteps = 120;
+  // hot block data, meshes not handed out yet and compressed columns
+  // it should fit the resident radius compressed, or columns evicted over it keep being reloaded
+  std::size_t memoryBudget = 64 * 1024 * 1024;
+  // terrain seed for columns missing on disk
+  uint32_t seed = ChunkGenerator::DefaultSeed;
+};
+
+struct RemeshedChunk {
+  int posX;
+  int posY;
+  int posZ;
+  MeshData mesh;
+};
+
+// keeps chunk columns around the camera in three tiers
+// hot columns are dense, warm columns are compressed in RAM and decompressed when accessed, and
+// cold columns only exist on disk and are loaded again through the I/O service when needed
+// sections of air and buried sections, which hold nothing but BuriedBlock, take up no chunk, so
+// memory and meshing follow the terrain surface rather than the height of the world
+// a buried section only gets a chunk once it is edited or one of its faces becomes visible
+struct ChunkResidency {
+public:
+  enum class Tier { eHot, eWarm, eCold };
+
+private:
+  // what generated terrain is made of below its surface
+  static constexpr Block::Type BuriedBlock = Block::Type::eDirt;
+
+  struct Entry {
+    Tier tier;
+    // only valid while the column is hot, and left invalid for sections of air and buried ones
+    std::array<ChunkHandle, Chunk::ColumnSections> sections;
+    // only set while the column is hot
+    ChunkCodec::SectionMask buried;
+    // encoded by ChunkCodec::encodeColumn while the column is warm
+    std::vector<uint8_t> compressed;
+    uint64_t lastAccess;
+    // modified since it was last written to disk
+    bool dirty;
+    bool loadRequested;
+  };
+
+  ChunkIOService &mChunkIO;
+  ChunkResidencySettings mSettings;
+  ChunkPool mPool;
+  // stands in for every buried section, as a neighbour for meshing and when encoding
+  Chunk mBuriedSection{};
+
+  ChunkMap<Entry> mEntries;
+  uint64_t mStep{0};
+  unsigned int mPendingLoads{0};
+
+  std::vector<RemeshedChunk> mRemeshedChunks;
+  std::vector<std::pair<int, int>> mEvictedChunks;
+
+  // reused between steps so streaming does not allocate
+  std::vector<ChunkLoadResult> mLoadResults;
+  // first of mLoadResults not received yet, polled again once every result is received
+  std::size_t mNextLoadResult{0};
+  std::vector<std::array<int, 3>> mChangedChunks;
+  std::vector<std::pair<int, int>> mBudgetCandidates;
+  ChunkRemeshQueue mPendingMeshes;
+  // sections of warm columns decoded for a single rebuild
+  std::vector<ChunkHandle> mScratchSections;
+
+  void receiveLoads();
+  void generateColumn(std::pair<int, int> const &position, Entry &entry);
+  // acquires the sections of entry from an encoded column, returns false and acquires nothing if
+  // it is invalid
+  [[nodiscard]] bool decodeColumn(std::pair<int, int> const &position, uint8_t const *data,
+                                  std::size_t const &size, Entry &entry);
+  void encodeColumn(Entry const &entry, std::vector<uint8_t> &output) const;
+  void releaseSections(Entry &entry);
+  [[nodiscard]] static bool isBuried(Entry const &entry, int const &posY);
+  // dense section without counting as an access, for sections that are only meshed or read for
+  // their borders
+  // buried sections are all mBuriedSection, and the sections of warm columns are decoded on their
+  // own into scratch chunks, so the column stays compressed
+  [[nodiscard]] Chunk *getDense(std::array<int, 3> const &position);
+  [[nodiscard]] Chunk &addScratchSection(std::array<int, 3> const &position);
+  void releaseScratchSections();
+  // whether every neighbour of a buried section is buried or solid, so it has no face to mesh
+  [[nodiscard]] bool isHidden(std::array<int, 3> const &position);
+  // gives a buried section a chunk of its own
+  [[nodiscard]] Chunk &materialize(std::array<int, 3> const &position, Entry &entry);
+  void remesh(std::array<int, 3> const &position, uint8_t const &parts);
+  // the borders facing the section at position of the sections around it that are in memory
+  void scheduleFacingBorders(std::array<int, 3> const &position);
+  // remeshes mChangedChunks and the borders of their neighbours that face them, along with
+  // everything scheduled before
+  void remeshChangedChunks();
+  void compress(Entry &entry);
+  void decompress(std::pair<int, int> const &position, Entry &entry);
+  void evict(std::pair<int, int> const &position, Entry &entry);
+  void enforceBudget(int const &cameraX, int const &cameraZ);
+
+  [[nodiscard]] std::size_t getEntryBytes(Entry const &entry) const;
+
+public:
+  ChunkResidency() = delete;
+  ChunkResidency(ChunkIOService &chunkIO, ChunkResidencySettings const &settings = {});
+  ChunkResidency(ChunkResidency const &) = delete;
+  // saves every modified column
+  ~ChunkResidency();
+
+  void operator=(ChunkResidency const &) = delete;
+
+  // streams chunks in around the camera and moves the others between tiers
+  void update(glm::vec3 const &cameraPosition);
+  // blocks until every requested column is in memory, for runs that must not depend on I/O timing
+  void finishLoads();
+
+  // dense section at (posX, posY, posZ), decompressed if needed, or nullptr while its column is not
+  // in memory
+  // sections of air are created on access so blocks can be placed in them
+  [[nodiscard]] Chunk *acquire(int const &posX, int const &posY, int const &posZ);
+  // schedules the column to be saved when it leaves memory and rebuilds the mesh of the section
+  void markModified(int const &posX, int const &posY, int const &posZ);
+
+  // replaces remeshedChunks with the meshes rebuilt since the last call, moved out of their chunks
+  void takeRemeshedChunks(std::vector<RemeshedChunk> &remeshedChunks);
+  // replaces evictedChunks with the columns dropped from memory since the last call, the meshes of
+  // their sections should be removed
+  void takeEvictedChunks(std::vector<std::pair<int, int>> &evictedChunks);
+  // gives back a mesh that is not needed anymore so a later rebuild can reuse its capacity
+  void recycleMesh(MeshData mesh);
+
+  [[nodiscard]] Tier getTier(int const &posX, int const &posZ) const;
+  [[nodiscard]] bool hasPendingLoads() const;
+  [[nodiscard]] std::size_t getMemoryUsage() const;
+  [[nodiscard]] std::size_t getColumnCount(Tier const &tier) const;
+};
+} // namespace cbl
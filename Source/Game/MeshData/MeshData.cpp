@@ -0,0 +1,11 @@
+#include "MeshData.hpp"
+
+namespace cbl {
+std::size_t MeshData::getIndicesSize() const { return sizeof(uint32_t) * indices.size(); }
+
+std::size_t MeshData::getVerticesSize() const { return sizeof(MeshVertex) * vertices.size(); }
+
+std::size_t MeshData::getReservedSize() const {
+  return sizeof(uint32_t) * indices.capacity() + sizeof(MeshVertex) * vertices.capacity();
+}
+} // namespace cbl
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace cbl {
+struct MeshVertex {
+  glm::vec3 position;
+  glm::vec3 uvw;
+};
+
+// mesh produced by the world on the CPU, the renderer converts it to its own format on upload
+struct MeshData {
+  std::vector<uint32_t> indices{};
+  std::vector<MeshVertex> vertices{};
+  glm::mat4 position{1};
+
+  [[nodiscard]] std::size_t getIndicesSize() const;
+  [[nodiscard]] std::size_t getVerticesSize() const;
+  // memory held by the vectors, including the capacity kept between rebuilds
+  [[nodiscard]] std::size_t getReservedSize() const;
+};
+} // namespace cbl
@@ -2,25 +2,96 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #define SDL_MAIN_HANDLED
 
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
 #include "Graphics/Engine/Engine.hpp"
 
-#include "Game/Chunks/Generator/ChunkGenerator.hpp"
+#include "Core/Input/Input.hpp"
+#include "Game/ChunkMeshSlots/ChunkMeshSlots.hpp"
+#include "Game/Chunks/IOService/ChunkIOService.hpp"
+#include "Game/Chunks/Residency/ChunkResidency.hpp"
 
 void setupScene(cbl::gfx::Engine &rendererEngine, cbl::World &scene) {}
 
-int main() {
-  cbl::gfx::Engine renderEngine{};
+// writes tightly packed BGRA8 pixels as a binary PPM
+void writePPM(std::string const &path, VkExtent2D const &extent,
+              std::vector<uint8_t> const &pixels) {
+  std::ofstream file{path, std::ios::binary};
+  file << "P6\n" << extent.width << " " << extent.height << "\n255\n";
 
-  auto chunks = cbl::ChunkGenerator::generateMany(5, 5);
+  for (size_t i = 0; i + 3 < pixels.size(); i += 4) {
+    char const rgb[3]{static_cast<char>(pixels[i + 2]), static_cast<char>(pixels[i + 1]),
+                      static_cast<char>(pixels[i])};
+    file.write(rgb, 3);
+  }
+}
 
-  cbl::World world;
-  for (auto const &chunk : chunks) {
-    world.meshes.push_back(chunk.second.mesh);
+int main(int argc, char *argv[]) {
+  // usage: Cobblestone [--headless <frames> [output.ppm] | --record <recording.cbir>]
+  cbl::gfx::EngineSettings settings{};
+  unsigned int headlessFrames = 0;
+  std::string readbackPath;
+  std::string recordingPath;
+  std::filesystem::path worldDirectory = "world";
+
+  if (argc >= 3 && std::strcmp(argv[1], "--headless") == 0) {
+    settings.headless = true;
+    headlessFrames = static_cast<unsigned int>(std::stoul(argv[2]));
+    if (argc >= 4) {
+      readbackPath = argv[3];
+    }
+  } else if (argc >= 3 && std::strcmp(argv[1], "--record") == 0) {
+    recordingPath = argv[2];
+    // replays start from freshly generated terrain, so recordings do too
+    worldDirectory = std::filesystem::temp_directory_path() / "cobblestone_recording";
+    std::filesystem::remove_all(worldDirectory);
   }
 
+  cbl::gfx::Engine renderEngine{settings};
+
+  cbl::ChunkIOService chunkIO{worldDirectory};
+  cbl::World world;
+
+  cbl::ChunkResidencySettings const residencySettings{};
+  cbl::ChunkResidency residency{chunkIO, residencySettings};
+  cbl::ChunkMeshSlots chunkMeshes{};
+
+  // the first ring is loaded before rendering starts, the rest streams in while moving
+  do {
+    residency.update(world.camera.getState().position);
+    std::this_thread::yield();
+  } while (residency.hasPendingLoads());
+  chunkMeshes.sync(residency, world);
+
+  world.onUpdate = [&residency, &chunkMeshes](cbl::World &updatedWorld) {
+    residency.update(updatedWorld.camera.getState().position);
+    chunkMeshes.sync(residency, updatedWorld);
+  };
+
   renderEngine.loadWorld(world);
 
-  renderEngine.run();
+  if (renderEngine.isHeadless()) {
+    renderEngine.renderFrames(headlessFrames);
+
+    if (!readbackPath.empty()) {
+      writePPM(readbackPath, renderEngine.getFrameExtent(), renderEngine.readbackLastFrame());
+    }
+  } else if (!recordingPath.empty()) {
+    cbl::InputRecording recording{};
+    recording.seed = residencySettings.seed;
+
+    cbl::Input::startRecording(recording);
+    renderEngine.run();
+    cbl::Input::stopRecording();
+
+    recording.save(recordingPath);
+  } else {
+    renderEngine.run();
+  }
 
   renderEngine.unloadWorld();
 
@@ -0,0 +1,47 @@
+#include "AllocationPanel.hpp"
+
+#include "External/imgui/imgui.h"
+
+#include "Core/Memory/AllocationTracker/AllocationTracker.hpp"
+
+namespace cbl::gfx {
+void AllocationPanel::draw() {
+  ImGui::Begin("Allocations");
+
+  if constexpr (!AllocationTracker::Enabled) {
+    ImGui::Text("Allocation tracking is compiled out, configure with "
+                "COBBLESTONE_ALLOCATION_TRACKING=ON");
+    ImGui::End();
+    return;
+  }
+
+  AllocationFrame const &frame = AllocationTracker::getLastFrame();
+  ImGui::Text("Last frame: %llu allocations, %llu bytes, %llu frees",
+              static_cast<unsigned long long>(frame.allocations),
+              static_cast<unsigned long long>(frame.bytes),
+              static_cast<unsigned long long>(frame.frees));
+
+  ImGui::Columns(3, "allocationSubsystems");
+  ImGui::Text("Subsystem");
+  ImGui::NextColumn();
+  ImGui::Text("Allocations");
+  ImGui::NextColumn();
+  ImGui::Text("Bytes");
+  ImGui::NextColumn();
+  ImGui::Separator();
+
+  for (std::size_t i = 0; i < frame.subsystemCount; i++) {
+    AllocationStats const &stats = frame.subsystems[i];
+
+    ImGui::Text("%s", stats.subsystem != nullptr ? stats.subsystem : "Other");
+    ImGui::NextColumn();
+    ImGui::Text("%llu", static_cast<unsigned long long>(stats.allocations));
+    ImGui::NextColumn();
+    ImGui::Text("%llu", static_cast<unsigned long long>(stats.bytes));
+    ImGui::NextColumn();
+  }
+
+  ImGui::Columns(1);
+  ImGui::End();
+}
+} // namespace cbl::gfx
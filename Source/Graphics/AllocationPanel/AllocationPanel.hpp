@@ -0,0 +1,11 @@
+#pragma once
+
+namespace cbl::gfx {
+// ImGui window with the heap allocations of the last frame, per subsystem
+struct AllocationPanel {
+public:
+  AllocationPanel() = delete;
+
+  static void draw();
+};
+} // namespace cbl::gfx
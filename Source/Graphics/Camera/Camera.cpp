@@ -13,6 +13,7 @@ namespace cbl::gfx {
 Camera::Camera() {
   Input::grabCursor();
   updateVectors();
+  mPreviousState = getState();
 }
 
 Camera::Camera(glm::vec3 const &position, glm::vec3 const &up, float const &yaw, float const &pitch)
@@ -21,10 +22,12 @@ Camera::Camera(glm::vec3 const &position, glm::vec3 const &up, float const &yaw,
   mUp = up;
   mYaw = yaw;
   mPitch = pitch;
+  updateVectors();
+  mPreviousState = getState();
 }
 
 void Camera::handleMouse() {
-  Vector2<int> currentMousePosition = Input::getMouseMovement();
+  Vector2<int> currentMousePosition = Input::consumeMouseMovement();
   mYaw += currentMousePosition.x * mMouseSensitivity;
   mPitch -= currentMousePosition.y * mMouseSensitivity;
   mPitch = std::clamp(mPitch, -89.0f, 89.0f);
@@ -32,19 +35,19 @@ void Camera::handleMouse() {
 
 void Camera::handleKeyboard() {
   float velocity = Time::deltaSeconds() * mMovementSpeed;
-  if (Input::keyPressed("Left Shift"))
+  if (Input::actionActive(InputAction::eSprint))
     velocity *= 3.0f;
-  if (Input::keyPressed("w"))
+  if (Input::actionActive(InputAction::eMoveForward))
     mPosition += mFront * velocity;
-  if (Input::keyPressed("s"))
+  if (Input::actionActive(InputAction::eMoveBackward))
     mPosition -= mFront * velocity;
-  if (Input::keyPressed("a"))
+  if (Input::actionActive(InputAction::eMoveLeft))
     mPosition -= mRight * velocity;
-  if (Input::keyPressed("d"))
+  if (Input::actionActive(InputAction::eMoveRight))
     mPosition += mRight * velocity;
-  if (Input::keyPressed("q"))
+  if (Input::actionActive(InputAction::eMoveDown))
     mPosition -= mUp * velocity;
-  if (Input::keyPressed("e"))
+  if (Input::actionActive(InputAction::eMoveUp))
     mPosition += mUp * velocity;
 }
 
@@ -59,8 +62,10 @@ void Camera::updateVectors() {
 }
 
 void Camera::update() {
+  mPreviousState = getState();
+
   if (mControlsEnabled) {
-    if (Input::keyPressed("Escape")) {
+    if (Input::actionActive(InputAction::eReleaseCursor)) {
       Input::releaseCursor();
       mControlsEnabled = false;
     }
@@ -76,12 +81,34 @@ void Camera::update() {
   updateVectors();
 }
 
-glm::mat4 Camera::getViewMatrix(float const aspectRatio) const {
-  glm::mat4 const view = lookAt(mPosition, mPosition + mFront, mUp);
-  glm::mat4 projection = glm::perspective(glm::radians(mFov), aspectRatio, mNearClip, mFarClip);
+glm::mat4 CameraState::getViewMatrix(float const aspectRatio) const {
+  glm::mat4 const view = lookAt(position, position + front, up);
+  glm::mat4 projection = glm::perspective(glm::radians(fov), aspectRatio, nearClip, farClip);
 
   projection[1][1] *= -1;
 
   return projection * view;
 }
+
+CameraState CameraState::interpolate(CameraState const &from, CameraState const &to,
+                                     float const &alpha) {
+  CameraState state = to;
+  state.position = glm::mix(from.position, to.position, alpha);
+  state.front = glm::normalize(glm::mix(from.front, to.front, alpha));
+  state.up = glm::normalize(glm::mix(from.up, to.up, alpha));
+
+  return state;
+}
+
+CameraState Camera::getState() const {
+  return CameraState{mPosition, mFront, mUp, mFov, mNearClip, mFarClip};
+}
+
+CameraState Camera::getInterpolatedState(float const &alpha) const {
+  return CameraState::interpolate(mPreviousState, getState(), alpha);
+}
+
+glm::mat4 Camera::getViewMatrix(float const aspectRatio) const {
+  return getState().getViewMatrix(aspectRatio);
+}
 } // namespace cbl::gfx
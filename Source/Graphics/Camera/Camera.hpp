@@ -6,9 +6,25 @@
 #include "Math/Vector/Vector2/Vector2.hpp"
 
 namespace cbl::gfx {
+// Everything the renderer needs to know about a camera, safe to copy across threads
+struct CameraState {
+  glm::vec3 position{0.0f};
+  glm::vec3 front{0.0f, 0.0f, -1.0f};
+  glm::vec3 up{0.0f, 1.0f, 0.0f};
+
+  float fov = 90.0f;
+  float nearClip = 0.01f;
+  float farClip = 500.0f;
+
+  [[nodiscard]] glm::mat4 getViewMatrix(float aspectRatio) const;
+  [[nodiscard]] static CameraState interpolate(CameraState const &from, CameraState const &to,
+                                               float const &alpha);
+};
+
 struct Camera {
 private:
-  glm::vec3 mPosition = glm::vec3(0.0f, 0.0f, -2.0f);
+  // starts above the terrain surface
+  glm::vec3 mPosition = glm::vec3(0.0f, 72.0f, -2.0f);
   glm::vec3 mFront = glm::vec3(0.0f, 0.0f, -1.0f);
   glm::vec3 mUp = glm::vec3(0.0f, 1.0f, 0.0f);
   glm::vec3 mRight = glm::vec3(1.0f, 0.0f, 0.0f);
@@ -26,6 +42,9 @@ private:
 
   bool mControlsEnabled = true;
 
+  // state before the last update, for rendering between simulation steps
+  CameraState mPreviousState{};
+
   void handleMouse();
   void handleKeyboard();
   void updateVectors();
@@ -36,6 +55,8 @@ public:
 
   void update();
 
+  [[nodiscard]] CameraState getState() const;
+  [[nodiscard]] CameraState getInterpolatedState(float const &alpha) const;
   [[nodiscard]] glm::mat4 getViewMatrix(float aspectRatio) const;
 };
 
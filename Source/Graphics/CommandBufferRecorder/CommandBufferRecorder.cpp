@@ -1,5 +1,6 @@
 #include "CommandBufferRecorder.hpp"
 
+#include <algorithm>
 #include <array>
 #include <stdexcept>
 
@@ -61,7 +62,8 @@ CommandBufferRecorder::addMeshBufferMemoryBarrier(mem::Buffer const &buffer,
 
 CommandBufferRecorder &CommandBufferRecorder::transitionImageLayout(
     mem::Image const &image, VkImageLayout const &oldLayout, VkImageLayout const &newLayout,
-    QueueFamilyIndices const &queueFamilyIndices) {
+    QueueFamilyIndices const &queueFamilyIndices, uint32_t const &baseMipLevel,
+    uint32_t const &levelCount) {
 
   VkImageMemoryBarrier barrier{};
   barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -71,8 +73,8 @@ CommandBufferRecorder &CommandBufferRecorder::transitionImageLayout(
   barrier.dstQueueFamilyIndex = queueFamilyIndices.transfer;
   barrier.image = image.image;
   barrier.subresourceRange.aspectMask = image.aspect;
-  barrier.subresourceRange.baseMipLevel = 0;
-  barrier.subresourceRange.levelCount = 1;
+  barrier.subresourceRange.baseMipLevel = baseMipLevel;
+  barrier.subresourceRange.levelCount = levelCount;
   barrier.subresourceRange.baseArrayLayer = 0;
   barrier.subresourceRange.layerCount = image.layers;
 
@@ -90,6 +92,20 @@ CommandBufferRecorder &CommandBufferRecorder::transitionImageLayout(
     barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
     barrier.dstAccessMask = 0;
 
+    sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    destinationStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+  } else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL &&
+             newLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+    sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+    destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+  } else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL &&
+             newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barrier.dstAccessMask = 0;
+
     sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
     destinationStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
   } else {
@@ -121,6 +137,75 @@ CommandBufferRecorder &CommandBufferRecorder::copyBufferToImage(mem::Buffer cons
   return *this;
 }
 
+CommandBufferRecorder &
+CommandBufferRecorder::copyBufferToImage(mem::Buffer const &src, mem::Image const &dst,
+                                         std::vector<VkBufferImageCopy> const &regions) {
+  vkCmdCopyBufferToImage(mCommandBuffer, src.buffer, dst.image,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                         static_cast<uint32_t>(regions.size()), regions.data());
+
+  return *this;
+}
+
+CommandBufferRecorder &CommandBufferRecorder::copyImageToBuffer(mem::Image const &src,
+                                                                mem::Buffer const &dst) {
+  VkBufferImageCopy region{};
+  region.bufferOffset = 0;
+  region.bufferRowLength = 0;
+  region.bufferImageHeight = 0;
+  region.imageSubresource.aspectMask = src.aspect;
+  region.imageSubresource.mipLevel = 0;
+  region.imageSubresource.baseArrayLayer = 0;
+  region.imageSubresource.layerCount = src.layers;
+  region.imageOffset = {0, 0, 0};
+  region.imageExtent = {src.extent.width, src.extent.height, 1};
+
+  vkCmdCopyImageToBuffer(mCommandBuffer, src.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         dst.buffer, 1, &region);
+
+  return *this;
+}
+
+CommandBufferRecorder &CommandBufferRecorder::blitMipLevel(mem::Image const &image,
+                                                           uint32_t const &sourceLevel) {
+  auto const sourceWidth = static_cast<int32_t>(std::max(1u, image.extent.width >> sourceLevel));
+  auto const sourceHeight = static_cast<int32_t>(std::max(1u, image.extent.height >> sourceLevel));
+
+  VkImageBlit blit{};
+  blit.srcSubresource.aspectMask = image.aspect;
+  blit.srcSubresource.mipLevel = sourceLevel;
+  blit.srcSubresource.baseArrayLayer = 0;
+  blit.srcSubresource.layerCount = image.layers;
+  blit.srcOffsets[1] = {sourceWidth, sourceHeight, 1};
+  blit.dstSubresource.aspectMask = image.aspect;
+  blit.dstSubresource.mipLevel = sourceLevel + 1;
+  blit.dstSubresource.baseArrayLayer = 0;
+  blit.dstSubresource.layerCount = image.layers;
+  blit.dstOffsets[1] = {std::max(1, sourceWidth / 2), std::max(1, sourceHeight / 2), 1};
+
+  vkCmdBlitImage(mCommandBuffer, image.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image.image,
+                 VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+  return *this;
+}
+
+CommandBufferRecorder &
+CommandBufferRecorder::generateMipmaps(mem::Image const &image,
+                                       QueueFamilyIndices const &queueFamilyIndices) {
+  // each level becomes a blit source once written, and is done once the next one is filled
+  for (uint32_t level = 0; level + 1 < image.mipLevels; level++) {
+    transitionImageLayout(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, queueFamilyIndices, level, 1);
+    blitMipLevel(image, level);
+    transitionImageLayout(image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, queueFamilyIndices, level, 1);
+  }
+
+  return transitionImageLayout(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, queueFamilyIndices,
+                               image.mipLevels - 1, 1);
+}
+
 CommandBufferRecorder &CommandBufferRecorder::setViewPort(VkExtent2D const &viewportExtent) {
   VkViewport viewport{};
   viewport.x = 0.0f;
@@ -208,6 +293,20 @@ CommandBufferRecorder &CommandBufferRecorder::endRenderPass() {
   return *this;
 }
 
+CommandBufferRecorder &CommandBufferRecorder::resetQueryPool(VkQueryPool const &queryPool,
+                                                             uint32_t const &firstQuery,
+                                                             uint32_t const &queryCount) {
+  vkCmdResetQueryPool(mCommandBuffer, queryPool, firstQuery, queryCount);
+  return *this;
+}
+
+CommandBufferRecorder &
+CommandBufferRecorder::writeTimestamp(VkQueryPool const &queryPool, uint32_t const &query,
+                                      VkPipelineStageFlagBits const &stage) {
+  vkCmdWriteTimestamp(mCommandBuffer, stage, queryPool, query);
+  return *this;
+}
+
 CommandBufferRecorder &CommandBufferRecorder::end() {
   validateVkResult(vkEndCommandBuffer(mCommandBuffer));
   return *this;
@@ -25,11 +25,23 @@ public:
   CommandBufferRecorder &addMeshBufferMemoryBarrier(mem::Buffer const &buffer,
                                                     QueueFamilyIndices const &queueFamilyIndices);
 
-  CommandBufferRecorder &transitionImageLayout(mem::Image const &image,
-                                               VkImageLayout const &oldLayout,
-                                               VkImageLayout const &newLayout,
-                                               QueueFamilyIndices const &queueFamilyIndices);
+  // only the mip levels in [baseMipLevel, baseMipLevel + levelCount) change layout
+  CommandBufferRecorder &
+  transitionImageLayout(mem::Image const &image, VkImageLayout const &oldLayout,
+                        VkImageLayout const &newLayout,
+                        QueueFamilyIndices const &queueFamilyIndices,
+                        uint32_t const &baseMipLevel = 0,
+                        uint32_t const &levelCount = VK_REMAINING_MIP_LEVELS);
   CommandBufferRecorder &copyBufferToImage(mem::Buffer const &src, mem::Image const &dst);
+  CommandBufferRecorder &copyBufferToImage(mem::Buffer const &src, mem::Image const &dst,
+                                           std::vector<VkBufferImageCopy> const &regions);
+  CommandBufferRecorder &copyImageToBuffer(mem::Image const &src, mem::Buffer const &dst);
+  // halves mip level sourceLevel into sourceLevel + 1 for every layer, needs a graphics queue
+  CommandBufferRecorder &blitMipLevel(mem::Image const &image, uint32_t const &sourceLevel);
+  // fills every level from level 0, which must be in TRANSFER_DST_OPTIMAL like the others, and
+  // leaves the whole chain in SHADER_READ_ONLY_OPTIMAL
+  CommandBufferRecorder &generateMipmaps(mem::Image const &image,
+                                         QueueFamilyIndices const &queueFamilyIndices);
 
   CommandBufferRecorder &setViewPort(VkExtent2D const &viewportExtent);
   CommandBufferRecorder &setScissor(VkRect2D const &scissorRect);
@@ -43,6 +55,11 @@ public:
   CommandBufferRecorder &drawMesh(Mesh const &mesh);
   CommandBufferRecorder &endRenderPass();
 
+  CommandBufferRecorder &resetQueryPool(VkQueryPool const &queryPool, uint32_t const &firstQuery,
+                                        uint32_t const &queryCount);
+  CommandBufferRecorder &writeTimestamp(VkQueryPool const &queryPool, uint32_t const &query,
+                                        VkPipelineStageFlagBits const &stage);
+
   CommandBufferRecorder &end();
   void submit(VkQueue const &submitQueue, VkFence const &fence = VK_NULL_HANDLE);
 };
@@ -1,26 +1,54 @@
 ﻿#include "Engine.hpp"
 
+#include <array>
+#include <stdexcept>
+#include <string>
+
 #include "External/imgui/backends/imgui_impl_vulkan.h"
 #include "External/imgui/imgui.h"
 
+#include "Core/Input/Input.hpp"
+#include "Core/Memory/AllocationTracker/AllocationTracker.hpp"
+#include "Core/Profiler/Profiler.hpp"
 #include "Core/Time/Time.hpp"
+#include "Graphics/AllocationPanel/AllocationPanel.hpp"
 #include "Graphics/CommandBufferRecorder/CommandBufferRecorder.hpp"
 #include "Graphics/Materials/ChunkMaterial/ChunkMaterial.hpp"
+#include "Graphics/ProfilerPanel/ProfilerPanel.hpp"
 #include "Graphics/Shaders/ChunkShader/ChunkShader.hpp"
 #include "Graphics/Utils/VulkanHelpers.hpp"
 
 namespace cbl::gfx {
-Engine::Engine()
-    : mWindow{}, mGPU{mWindow}, mMemoryManager{mGPU},
-      mSwapchain{mGPU, mWindow, mMemoryManager}, mFrames{Frame{mGPU}, Frame{mGPU}} {
-
-  mState.currentFrame = &mFrames[mState.currentFrameNumber];
-  initImgui();
+Engine::Engine(EngineSettings const &settings)
+    : mWindow{settings.headless ? nullptr : std::make_unique<Window>()},
+      mGPU{mWindow ? GPU{*mWindow} : GPU{}}, mMemoryManager{mGPU, mJobs, settings.maxAnisotropy},
+      mTextures{mGPU, mMemoryManager},
+      mSwapchain{mWindow ? std::make_unique<Swapchain>(mGPU, *mWindow, mMemoryManager) : nullptr},
+      mOffscreenTarget{mWindow ? nullptr
+                               : std::make_unique<OffscreenTarget>(mGPU, mMemoryManager,
+                                                                   settings.headlessExtent,
+                                                                   MaxFramesInFlight)},
+      mTimestampPeriod{mGPU.getTimestampPeriod()} {
+
+  createFrames(settings.framesInFlight);
+
+  if (!isHeadless()) {
+    initImgui();
+  }
 }
 
 Engine::~Engine() {
-  vkDestroyDescriptorPool(mGPU.device, imguiPool, nullptr);
-  ImGui_ImplVulkan_Shutdown();
+  stopRenderThread();
+  unloadWorld();
+
+  for (std::unique_ptr<Frame> &frame : mFrames) {
+    releaseRetiredBuffers(*frame);
+  }
+
+  if (!isHeadless()) {
+    vkDestroyDescriptorPool(mGPU.device, imguiPool, nullptr);
+    ImGui_ImplVulkan_Shutdown();
+  }
 }
 
 void Engine::initImgui() {
@@ -47,8 +75,17 @@ void Engine::initImgui() {
   validateVkResult(vkCreateDescriptorPool(mGPU.device, &pool_info, nullptr, &imguiPool));
 
   // 2: initialize imgui library
+  if constexpr (AllocationTracker::Enabled) {
+    // imgui allocates with malloc by default, which the tracker does not see
+    ImGui::SetAllocatorFunctions(
+        [](std::size_t size, void *) -> void * {
+          CBL_ALLOCATION_SCOPE("ImGui");
+          return ::operator new(size);
+        },
+        [](void *pointer, void *) { ::operator delete(pointer); });
+  }
   ImGui::CreateContext();
-  mWindow.initImgui();
+  mWindow->initImgui();
 
   ImGui_ImplVulkan_InitInfo init_info = {};
   init_info.Instance = mGPU.instance;
@@ -56,130 +93,522 @@ void Engine::initImgui() {
   init_info.Device = mGPU.device;
   init_info.Queue = mGPU.graphicsQueue;
   init_info.DescriptorPool = imguiPool;
-  init_info.MinImageCount = static_cast<uint32_t>(mSwapchain.frameBufferImages.size());
-  init_info.ImageCount = static_cast<uint32_t>(mSwapchain.frameBufferImages.size());
+  init_info.MinImageCount = static_cast<uint32_t>(mSwapchain->frameBufferImages.size());
+  init_info.ImageCount = static_cast<uint32_t>(mSwapchain->frameBufferImages.size());
 
-  ImGui_ImplVulkan_Init(&init_info, mSwapchain.renderPass);
+  ImGui_ImplVulkan_Init(&init_info, mSwapchain->renderPass);
 
-  CommandBufferRecorder recorder{mState.currentFrame->commandBuffer};
+  CommandBufferRecorder recorder{mRenderState.currentFrame->commandBuffer};
   recorder.beginOneTime();
-  ImGui_ImplVulkan_CreateFontsTexture(mState.currentFrame->commandBuffer);
+  ImGui_ImplVulkan_CreateFontsTexture(mRenderState.currentFrame->commandBuffer);
   recorder.end().submit(mGPU.graphicsQueue);
 }
 
-bool Engine::acquireNextFrame() {
-  validateVkResult(vkWaitForFences(mGPU.device, 1, &mState.currentFrame->renderFinishedFence,
-                                   VK_TRUE, UINT64_MAX));
+void Engine::createFrames(unsigned int const &framesInFlight) {
+  if (framesInFlight < MinFramesInFlight || framesInFlight > MaxFramesInFlight) {
+    throw std::out_of_range("Frames in flight must be between " +
+                            std::to_string(MinFramesInFlight) + " and " +
+                            std::to_string(MaxFramesInFlight));
+  }
+
+  mGPU.waitIdle();
 
-  if (VkResult result = vkAcquireNextImageKHR(mGPU.device, mSwapchain.swapchain, UINT64_MAX,
-                                              mState.currentFrame->imageAvailableSemaphore,
-                                              VK_NULL_HANDLE, &mState.imageIndex);
-      result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+  for (std::unique_ptr<Frame> &frame : mFrames) {
+    releaseRetiredBuffers(*frame);
+  }
+
+  mFrames.clear();
+  mFrames.reserve(framesInFlight);
+  for (unsigned int i = 0; i < framesInFlight; i++) {
+    mFrames.push_back(std::make_unique<Frame>(mGPU));
+  }
+
+  mMaxFramesInFlight = framesInFlight;
+  mRenderState.currentFrameNumber = 0;
+  mRenderState.currentFrame = mFrames[mRenderState.currentFrameNumber].get();
+  mImagesInFlight.assign(getTargetImageCount(), VK_NULL_HANDLE);
+}
+
+void Engine::releaseRetiredBuffers(Frame &frame) {
+  for (mem::Buffer &buffer : frame.retiredBuffers) {
+    mMemoryManager.destroyBuffer(buffer);
+  }
+  frame.retiredBuffers.clear();
+}
+
+void Engine::waitForCurrentFrame() {
+  validateVkResult(vkWaitForFences(mGPU.device, 1,
+                                   &mRenderState.currentFrame->renderFinishedFence, VK_TRUE,
+                                   UINT64_MAX));
+  releaseRetiredBuffers(*mRenderState.currentFrame);
+  collectGpuTimings(*mRenderState.currentFrame);
+}
+
+void Engine::collectGpuTimings(Frame &frame) {
+  if (!frame.timestampsWritten) {
+    return;
+  }
+  frame.timestampsWritten = false;
+
+  std::array<uint64_t, Frame::TimestampQueryCount> timestamps{};
+  if (vkGetQueryPoolResults(mGPU.device, frame.timestampQueryPool, 0, Frame::TimestampQueryCount,
+                            sizeof(timestamps), timestamps.data(), sizeof(uint64_t),
+                            VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+    return;
+  }
+
+  // GPU clocks are not calibrated against the CPU, so the pass is placed at its submission time
+  auto const durationNs =
+      static_cast<uint64_t>(static_cast<double>(timestamps[1] - timestamps[0]) * mTimestampPeriod);
+  Profiler::recordGpu("Scene render pass", frame.submittedAtNs, durationNs);
+}
+
+bool Engine::acquireNextFrame() {
+  if (isHeadless()) {
+    mRenderState.imageIndex =
+        static_cast<unsigned int>((mRenderState.imageIndex + 1) % getTargetImageCount());
+  } else if (VkResult result = vkAcquireNextImageKHR(
+                 mGPU.device, mSwapchain->swapchain, UINT64_MAX,
+                 mRenderState.currentFrame->imageAvailableSemaphore, VK_NULL_HANDLE,
+                 &mRenderState.imageIndex);
+             result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
     return false;
   } else {
     // Image acquired
     validateVkResult(result);
   }
 
-  validateVkResult(vkResetFences(mGPU.device, 1, &mState.currentFrame->renderFinishedFence));
+  // with more frames in flight than swapchain images, an older frame may still be using this image
+  if (VkFence &imageFence = mImagesInFlight[mRenderState.imageIndex];
+      imageFence != VK_NULL_HANDLE &&
+      imageFence != mRenderState.currentFrame->renderFinishedFence) {
+    validateVkResult(vkWaitForFences(mGPU.device, 1, &imageFence, VK_TRUE, UINT64_MAX));
+  }
+  mImagesInFlight[mRenderState.imageIndex] = mRenderState.currentFrame->renderFinishedFence;
+
+  validateVkResult(
+      vkResetFences(mGPU.device, 1, &mRenderState.currentFrame->renderFinishedFence));
   return true;
 }
 
-void Engine::drawScene() {
-  if (mState.currentScene == nullptr) {
+void Engine::submitCurrentFrame() {
+  Frame &frame = *mRenderState.currentFrame;
+
+  constexpr VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+  VkSubmitInfo submitInfo{};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &frame.commandBuffer;
+
+  // offscreen images are not acquired nor presented
+  if (!isHeadless()) {
+    submitInfo.pWaitDstStageMask = &waitStage;
+    submitInfo.waitSemaphoreCount = 1;
+    submitInfo.pWaitSemaphores = &frame.imageAvailableSemaphore;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &frame.renderFinishedSemaphore;
+  }
+
+  validateVkResult(vkQueueSubmit(mGPU.graphicsQueue, 1, &submitInfo, frame.renderFinishedFence));
+
+  if (!isHeadless()) {
+    VkPresentInfoKHR presentInfo{};
+    presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+    presentInfo.waitSemaphoreCount = 1;
+    presentInfo.pWaitSemaphores = &frame.renderFinishedSemaphore;
+    presentInfo.swapchainCount = 1;
+    presentInfo.pSwapchains = &mSwapchain->swapchain;
+    presentInfo.pImageIndices = &mRenderState.imageIndex;
+
+    validateVkResult(vkQueuePresentKHR(mGPU.presentQueue, &presentInfo));
+  }
+
+  mRenderState.renderedFrames++;
+}
+
+VkRenderPass Engine::getRenderPass() const {
+  return mSwapchain ? mSwapchain->renderPass : mOffscreenTarget->renderPass;
+}
+
+VkFramebuffer Engine::getFramebuffer(unsigned int const &imageIndex) const {
+  return mSwapchain ? mSwapchain->framebuffers[imageIndex]
+                    : mOffscreenTarget->framebuffers[imageIndex];
+}
+
+float Engine::getAspectRatio() const {
+  return mSwapchain ? mSwapchain->getAspectRatio() : mOffscreenTarget->getAspectRatio();
+}
+
+size_t Engine::getTargetImageCount() const {
+  return mSwapchain ? mSwapchain->framebuffers.size() : mOffscreenTarget->framebuffers.size();
+}
+
+void Engine::startRenderThread() {
+  if (mRenderThread.joinable()) {
     return;
   }
 
-  if (!mState.shouldRender || !acquireNextFrame()) {
-    if (mSwapchain.isValid(mWindow)) {
-      mSwapchain.handleFrameBufferResize(mWindow);
+  mRenderThreadFailed = false;
+  mSnapshots.open();
+  mRenderThread = std::thread{&Engine::renderLoop, this};
+}
+
+void Engine::stopRenderThread() {
+  // wakes the render thread if it is waiting for a snapshot
+  mSnapshots.close();
+
+  if (mRenderThread.joinable()) {
+    mRenderThread.join();
+  }
+}
+
+void Engine::renderLoop() {
+  Profiler::setThreadName("Render thread");
+
+  try {
+    while (mSnapshots.waitForPublish()) {
+      if (mSnapshots.consume()) {
+        drawScene(mSnapshots.front());
+      }
+    }
+  } catch (...) {
+    mRenderThreadException = std::current_exception();
+    mRenderThreadFailed.store(true, std::memory_order_release);
+  }
+}
+
+void Engine::applyMeshChanges() {
+  CBL_PROFILE_SCOPE("Engine::applyMeshChanges");
+  MeshChange change{};
+  while (mMeshChanges.tryPop(change)) {
+    if (change.meshId >= mRenderState.meshes.size()) {
+      mRenderState.meshes.resize(change.meshId + 1, Mesh{{}, {}});
+    }
+
+    Mesh &mesh = mRenderState.meshes[change.meshId];
+
+    // earlier frames may still be reading the old buffer
+    if (mesh.buffer.isValid) {
+      mRenderState.currentFrame->retiredBuffers.push_back(mesh.buffer);
+      mesh.buffer = {};
+    }
+
+    if (change.type == MeshChange::Type::eDestroy) {
+      mesh.indices.clear();
+      mesh.vertices.clear();
+      continue;
+    }
+
+    // the old buffer was retired above, so nothing is lost by replacing the mesh
+    mesh = Mesh{std::move(change.mesh)};
+
+    if (!mesh.indices.empty()) {
+      mMemoryManager.generateMeshBuffer(mesh);
     }
-    return;
   }
+}
 
-  ImGui::Render();
+void Engine::drawScene(RenderSnapshot const &snapshot) {
+  CBL_PROFILE_SCOPE("Engine::drawScene");
+  CBL_ALLOCATION_SCOPE("Renderer");
+
+  if (unsigned int const requestedFramesInFlight = mRequestedFramesInFlight.exchange(0);
+      requestedFramesInFlight != 0) {
+    createFrames(requestedFramesInFlight);
+  }
 
   VkRect2D renderArea;
   renderArea.offset = {0, 0};
-  renderArea.extent = mSwapchain.frameBufferImages[0].extent;
+  renderArea.extent = getFrameExtent();
+
+  glm::mat4 const cameraView = snapshot.camera.getViewMatrix(getAspectRatio());
+
+  if (!mRenderState.shouldRender) {
+    return;
+  }
+
+  waitForCurrentFrame();
+
+  if (!acquireNextFrame()) {
+    if (mSwapchain->isValid(*mWindow)) {
+      mSwapchain->handleFrameBufferResize(*mWindow);
+      mImagesInFlight.assign(getTargetImageCount(), VK_NULL_HANDLE);
+    }
+    return;
+  }
 
-  CommandBufferRecorder recorder{mState.currentFrame->commandBuffer};
-  recorder.beginOneTime()
-      .setViewPort(renderArea.extent)
+  applyMeshChanges();
+
+  Frame &frame = *mRenderState.currentFrame;
+  bool const writeTimestamps = Profiler::Enabled && mTimestampPeriod > 0.0f;
+
+  CommandBufferRecorder recorder{frame.commandBuffer};
+  recorder.beginOneTime();
+
+  if (writeTimestamps) {
+    recorder.resetQueryPool(frame.timestampQueryPool, 0, Frame::TimestampQueryCount)
+        .writeTimestamp(frame.timestampQueryPool, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+  }
+
+  FrameStats stats{};
+
+  recorder.setViewPort(renderArea.extent)
       .setScissor(renderArea)
-      .beginRenderPass(mSwapchain.renderPass, mSwapchain.framebuffers[mState.imageIndex],
-                       renderArea);
+      .beginRenderPass(getRenderPass(), getFramebuffer(mRenderState.imageIndex), renderArea);
 
-  for (BaseShader const *shader : mState.currentScene->shaders) {
+  for (BaseShader const *shader : snapshot.shaders) {
     if (!shader) {
       continue;
     }
 
     recorder
         .bindGraphicsShader(*shader) //
-        .pushCameraView(mState.currentScene->camera.getViewMatrix(mSwapchain.getAspectRatio()),
-                        *shader);
+        .pushCameraView(cameraView, *shader);
 
-    for (BaseMaterial const *material : mState.currentScene->materials) {
+    for (BaseMaterial const *material : snapshot.materials) {
       if (!material) {
         continue;
       }
 
       recorder.bindMaterial(*shader, *material);
 
-      for (Mesh const &mesh : mState.currentScene->meshes) {
+      for (std::size_t const &meshId : snapshot.visibleMeshes) {
+        if (meshId >= mRenderState.meshes.size()) {
+          continue;
+        }
+
+        Mesh const &mesh = mRenderState.meshes[meshId];
         recorder
             .pushModelPosition(mesh.position, *shader) //
             .drawMesh(mesh);
+
+        if (mesh.buffer.isValid) {
+          stats.drawCalls++;
+          stats.triangles += mesh.indices.size() / 3;
+        }
       }
     }
   }
 
-  ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), mState.currentFrame->commandBuffer);
+  if (snapshot.imgui.drawData.Valid) {
+    // the draw data is const-correct in use but not in the backend signature
+    ImGui_ImplVulkan_RenderDrawData(const_cast<ImDrawData *>(&snapshot.imgui.drawData),
+                                    frame.commandBuffer);
+  }
 
-  recorder.endRenderPass().end();
+  recorder.endRenderPass();
 
-  constexpr VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-  VkSubmitInfo submitInfo{};
-  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-  submitInfo.pWaitDstStageMask = &waitStage;
-  submitInfo.waitSemaphoreCount = 1;
-  submitInfo.pWaitSemaphores = &mState.currentFrame->imageAvailableSemaphore;
-  submitInfo.signalSemaphoreCount = 1;
-  submitInfo.pSignalSemaphores = &mState.currentFrame->renderFinishedSemaphore;
-  submitInfo.commandBufferCount = 1;
-  submitInfo.pCommandBuffers = &mState.currentFrame->commandBuffer;
+  if (writeTimestamps) {
+    recorder.writeTimestamp(frame.timestampQueryPool, 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+  }
 
-  validateVkResult(
-      vkQueueSubmit(mGPU.graphicsQueue, 1, &submitInfo, mState.currentFrame->renderFinishedFence));
+  recorder.end();
+
+  frame.timestampsWritten = writeTimestamps;
+  frame.submittedAtNs = Profiler::nowNs();
+  submitCurrentFrame();
+  mRenderState.lastFrameStats = stats;
+
+  mRenderState.currentFrame =
+      mFrames[++mRenderState.currentFrameNumber %= mMaxFramesInFlight].get();
+}
+
+void Engine::queueMeshChanges() {
+  CBL_ALLOCATION_SCOPE("Mesh changes");
+  World &scene = *mState.currentScene;
+
+  for (std::size_t const &meshIndex : scene.mDirtyMeshes) {
+    if (meshIndex >= scene.meshes.size()) {
+      continue;
+    }
 
-  VkPresentInfoKHR presentInfo{};
-  presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-  presentInfo.waitSemaphoreCount = 1;
-  presentInfo.pWaitSemaphores = &mState.currentFrame->renderFinishedSemaphore;
-  presentInfo.swapchainCount = 1;
-  presentInfo.pSwapchains = &mSwapchain.swapchain;
-  presentInfo.pImageIndices = &mState.imageIndex;
+    mState.pendingMeshChanges.push_back(
+        MeshChange{MeshChange::Type::eUpload, meshIndex, scene.meshes[meshIndex]});
+  }
+  scene.mDirtyMeshes.clear();
+
+  // whatever does not fit in the queue is retried next frame instead of blocking
+  auto firstPending = mState.pendingMeshChanges.begin();
+  while (firstPending != mState.pendingMeshChanges.end() &&
+         mMeshChanges.tryPush(std::move(*firstPending))) {
+    ++firstPending;
+  }
+  mState.pendingMeshChanges.erase(mState.pendingMeshChanges.begin(), firstPending);
+}
+
+void Engine::publishSnapshot(float const &interpolationAlpha) {
+  CBL_ALLOCATION_SCOPE("Snapshot");
+  World const &scene = *mState.currentScene;
+  RenderSnapshot &snapshot = mSnapshots.back();
+
+  snapshot.camera = scene.camera.getInterpolatedState(interpolationAlpha);
 
-  validateVkResult(vkQueuePresentKHR(mGPU.presentQueue, &presentInfo));
+  // draws using a pipeline still being built are skipped until it is ready
+  snapshot.shaders.clear();
+  for (BaseShader *shader : scene.shaders) {
+    if (shader != nullptr && shader->isPipelineReady()) {
+      snapshot.shaders.push_back(shader);
+    }
+  }
+
+  snapshot.materials.assign(scene.materials.begin(), scene.materials.end());
 
-  mState.currentFrame = &mFrames[++mState.currentFrameNumber %= mMaxFramesInFlight];
+  snapshot.visibleMeshes.clear();
+  for (std::size_t i = 0; i < scene.meshes.size(); i++) {
+    snapshot.visibleMeshes.push_back(i);
+  }
+
+  if (isHeadless()) {
+    snapshot.imgui.clear();
+  } else {
+    snapshot.imgui.capture(ImGui::GetDrawData());
+  }
+
+  mSnapshots.publish();
 }
 
 void Engine::run() {
-  while (mWindow.isOpen()) {
+  if (isHeadless()) {
+    throw std::logic_error("Headless engines are driven with renderFrames");
+  }
+
+  Profiler::setThreadName("Main thread");
+  startRenderThread();
+
+  while (mWindow->isOpen()) {
+    CBL_PROFILE_SCOPE("Engine::run frame");
+
+    if (mRenderThreadFailed.load(std::memory_order_acquire)) {
+      stopRenderThread();
+      std::rethrow_exception(mRenderThreadException);
+    }
+
+    mState.frameArena.reset();
+    AllocationTracker::endFrame();
+
     Time::tick();
-    ImGui_ImplVulkan_NewFrame();
-    mWindow.update();
-    ImGui::NewFrame();
-    ImGui::ShowMetricsWindow();
+    {
+      CBL_ALLOCATION_SCOPE("Window and UI");
+      ImGui_ImplVulkan_NewFrame();
+      mWindow->update(mState.frameArena);
+      ImGui::NewFrame();
+      ImGui::ShowMetricsWindow();
+      ProfilerPanel::draw(mState.frameArena);
+      AllocationPanel::draw();
+
+      ImGui::Begin("Renderer");
+      int framesInFlight = static_cast<int>(getFramesInFlight());
+      if (ImGui::SliderInt("Frames in flight", &framesInFlight, MinFramesInFlight,
+                           MaxFramesInFlight)) {
+        setFramesInFlight(static_cast<unsigned int>(framesInFlight));
+      }
+      ImGui::End();
+    }
 
-    mState.currentScene->update();
-    drawScene();
+    // the simulation advances in fixed steps, independently of how fast frames are produced
+    while (Time::consumeFixedStep()) {
+      CBL_PROFILE_SCOPE("World::update");
+      CBL_ALLOCATION_SCOPE("World");
+
+      if (mState.currentScene != nullptr) {
+        Input::beginTick();
+        mState.currentScene->update();
+      }
+    }
+
+    {
+      CBL_ALLOCATION_SCOPE("Window and UI");
+      ImGui::Render();
+    }
+
+    if (mState.currentScene != nullptr) {
+      queueMeshChanges();
+      // a snapshot the render thread has not taken yet is replaced, mesh changes stay queued
+      publishSnapshot(Time::interpolationAlpha());
+      Time::waitForFrame();
+    } else {
+      Time::waitForFixedStep();
+    }
+  }
+
+  stopRenderThread();
+}
+
+void Engine::renderFrames(unsigned int const &frameCount) {
+  if (!isHeadless()) {
+    throw std::logic_error("Only headless engines can be driven frame by frame");
+  }
+
+  // frames drawn without their pipelines would make the output depend on timing
+  if (mState.currentScene != nullptr) {
+    for (BaseShader const *shader : mState.currentScene->shaders) {
+      shader->waitForPipeline();
+    }
+  }
+
+  // one simulation step per frame keeps headless runs deterministic
+  for (unsigned int i = 0; i < frameCount; i++) {
+    mState.frameArena.reset();
+    AllocationTracker::endFrame();
+
+    if (mState.currentScene != nullptr) {
+      CBL_ALLOCATION_SCOPE("World");
+      Input::beginTick();
+      mState.currentScene->update();
+      queueMeshChanges();
+      publishSnapshot(1.0f);
+    }
+
+    if (mSnapshots.consume()) {
+      drawScene(mSnapshots.front());
+    }
+  }
+}
+
+std::vector<uint8_t> Engine::readbackLastFrame() {
+  if (!isHeadless()) {
+    throw std::logic_error("Frames can only be read back from headless engines");
   }
+
+  if (mRenderState.renderedFrames == 0) {
+    throw std::logic_error("No frame has been rendered yet");
+  }
+
+  mGPU.waitIdle();
+  return mOffscreenTarget->readback(mRenderState.imageIndex,
+                                    mRenderState.currentFrame->commandBuffer, mGPU.graphicsQueue);
+}
+
+FrameStats Engine::getLastFrameStats() const {
+  if (!isHeadless()) {
+    throw std::logic_error("Frame stats are only available on headless engines");
+  }
+
+  return mRenderState.lastFrameStats;
 }
 
-bool Engine::isRunning() { return mWindow.isOpen(); }
+bool Engine::isRunning() { return mWindow && mWindow->isOpen(); }
+
+bool Engine::isHeadless() const { return mWindow == nullptr; }
+
+VkExtent2D Engine::getFrameExtent() const {
+  return mSwapchain ? mSwapchain->frameBufferImages[0].extent
+                    : mOffscreenTarget->frameBufferImages[0].extent;
+}
+
+void Engine::setFramesInFlight(unsigned int const &framesInFlight) {
+  if (framesInFlight < MinFramesInFlight || framesInFlight > MaxFramesInFlight) {
+    throw std::out_of_range("Frames in flight must be between " +
+                            std::to_string(MinFramesInFlight) + " and " +
+                            std::to_string(MaxFramesInFlight));
+  }
+
+  // applied by the render thread before its next frame, so the frame being recorded keeps its
+  // resources
+  mRequestedFramesInFlight = framesInFlight;
+}
+
+unsigned int Engine::getFramesInFlight() const { return mMaxFramesInFlight; }
 
 void Engine::loadWorld(World &scene) {
   if (mState.currentScene != nullptr) {
@@ -188,15 +617,14 @@ void Engine::loadWorld(World &scene) {
 
   mState.currentScene = &scene;
 
-  for (Mesh &mesh : mState.currentScene->meshes) {
-    if (!mesh.buffer.isValid) {
-      mMemoryManager.generateMeshBuffer(mesh);
-    }
+  for (std::size_t i = 0; i < mState.currentScene->meshes.size(); i++) {
+    mState.currentScene->invalidateMesh(i);
   }
 
-  mState.currentScene->shaders.push_back(new ChunkShader{mGPU, mSwapchain.renderPass});
-  mState.currentScene->materials.push_back(
-      new ChunkMaterial{mGPU, mMemoryManager, mState.currentScene->shaders[0]});
+  auto *material = new ChunkMaterial{mGPU, mMemoryManager, mTextures};
+  mState.currentScene->materials.push_back(material);
+  mState.currentScene->shaders.push_back(
+      new ChunkShader{mGPU, getRenderPass(), mJobs, mTextures, material->getTextureBase()});
 }
 
 void Engine::unloadWorld() {
@@ -204,21 +632,38 @@ void Engine::unloadWorld() {
     return;
   }
 
+  // the render thread holds pointers to the shaders and materials about to be deleted
+  stopRenderThread();
   mGPU.waitIdle();
 
-  for (Mesh &mesh : mState.currentScene->meshes) {
+  // drop everything the render thread did not get to, it references the world being unloaded
+  if (mSnapshots.consume()) {
+    mSnapshots.front().imgui.clear();
+  }
+
+  MeshChange change{};
+  while (mMeshChanges.tryPop(change)) {
+  }
+  mState.pendingMeshChanges.clear();
+
+  for (Mesh &mesh : mRenderState.meshes) {
     if (mesh.buffer.isValid) {
-      mesh.buffer.memoryManager->destroyBuffer(mesh.buffer);
+      mMemoryManager.destroyBuffer(mesh.buffer);
     }
   }
+  mRenderState.meshes.clear();
 
   for (BaseMaterial *material : mState.currentScene->materials) {
     delete material;
   }
+  mState.currentScene->materials.clear();
 
   for (BaseShader *shader : mState.currentScene->shaders) {
     delete shader;
   }
+  mState.currentScene->shaders.clear();
+
+  mTextures.clear();
 
   mState.currentScene = nullptr;
 }
@@ -1,9 +1,17 @@
 ﻿#pragma once
 
-#include <array>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include <vulkan/vulkan.h>
 
+#include "Core/Threading/SPSCQueue/SPSCQueue.hpp"
+#include "Core/Threading/ThreadPool/ThreadPool.hpp"
+#include "Core/Threading/TripleBuffer/TripleBuffer.hpp"
 #include "Core/World/World.hpp"
 #include "Graphics/Camera/Camera.hpp"
 #include "Graphics/Frame/Frame.hpp"
@@ -11,39 +19,108 @@
 #include "Graphics/Memory/Buffer/Buffer.hpp"
 #include "Graphics/Memory/MemoryManager/MemoryManager.hpp"
 #include "Graphics/Mesh/Mesh.hpp"
+#include "Graphics/OffscreenTarget/OffscreenTarget.hpp"
+#include "Graphics/RenderSnapshot/RenderSnapshot.hpp"
 #include "Graphics/Swapchain/Swapchain.hpp"
+#include "Core/Memory/FrameArena/FrameArena.hpp"
+#include "Graphics/TextureRegistry/TextureRegistry.hpp"
 #include "Graphics/Window/Window.hpp"
 
 namespace cbl::gfx {
 
+struct EngineSettings {
+  unsigned int framesInFlight = 2;
+  // render into offscreen images without a window, driven by Engine::renderFrames
+  bool headless = false;
+  VkExtent2D headlessExtent{1280, 720};
+  // texture sampler anisotropy, clamped to the device limit, 1 disables it
+  float maxAnisotropy = 16.0f;
+};
+
+// what one frame submitted to the GPU
+struct FrameStats {
+  unsigned int drawCalls = 0;
+  uint64_t triangles = 0;
+};
+
 struct Engine {
 private:
+  // main thread state
   struct {
     World *currentScene = nullptr;
+    std::vector<MeshChange> pendingMeshChanges{};
+    // transient data of the current main thread frame, reset when the next one starts
+    FrameArena frameArena{};
+  } mState;
+
+  // render thread state
+  struct {
     Frame *currentFrame = nullptr;
     unsigned int currentFrameNumber = 0;
     unsigned int imageIndex = 0;
+    uint64_t renderedFrames = 0;
     bool shouldRender = true;
-  } mState;
+    std::vector<Mesh> meshes{};
+    FrameStats lastFrameStats{};
+  } mRenderState;
 
-  Window mWindow;
+  // either a window and its swapchain, or an offscreen target when headless
+  std::unique_ptr<Window> mWindow;
 
   GPU mGPU;
+  // background work such as pipeline creation and texture decoding
+  ThreadPool mJobs;
   mem::MemoryManager mMemoryManager;
+  // bindless texture array shared by every material
+  TextureRegistry mTextures;
 
-  Swapchain mSwapchain;
+  std::unique_ptr<Swapchain> mSwapchain;
+  std::unique_ptr<OffscreenTarget> mOffscreenTarget;
 
-  static constexpr unsigned int mMaxFramesInFlight = 2;
-  std::array<Frame, mMaxFramesInFlight> mFrames;
+  std::atomic<unsigned int> mMaxFramesInFlight{};
+  std::atomic<unsigned int> mRequestedFramesInFlight{0};
+  std::vector<std::unique_ptr<Frame>> mFrames;
+  // fence of the frame currently rendering to each target image
+  std::vector<VkFence> mImagesInFlight;
 
-  VkDescriptorPool imguiPool;
+  float mTimestampPeriod{};
+
+  VkDescriptorPool imguiPool{};
   void initImgui();
 
+  std::thread mRenderThread;
+  std::atomic<bool> mRenderThreadFailed{false};
+  std::exception_ptr mRenderThreadException;
+
+  TripleBuffer<RenderSnapshot> mSnapshots;
+  SPSCQueue<MeshChange, 1024> mMeshChanges;
+
+  void createFrames(unsigned int const &framesInFlight);
+  void releaseRetiredBuffers(Frame &frame);
+  void waitForCurrentFrame();
+  void collectGpuTimings(Frame &frame);
   bool acquireNextFrame();
-  void drawScene();
+  void submitCurrentFrame();
+
+  [[nodiscard]] VkRenderPass getRenderPass() const;
+  [[nodiscard]] VkFramebuffer getFramebuffer(unsigned int const &imageIndex) const;
+  [[nodiscard]] float getAspectRatio() const;
+  [[nodiscard]] size_t getTargetImageCount() const;
+
+  void startRenderThread();
+  void stopRenderThread();
+  void renderLoop();
+  void applyMeshChanges();
+  void drawScene(RenderSnapshot const &snapshot);
+
+  void queueMeshChanges();
+  void publishSnapshot(float const &interpolationAlpha);
 
 public:
-  Engine();
+  static constexpr unsigned int MinFramesInFlight = 1;
+  static constexpr unsigned int MaxFramesInFlight = 4;
+
+  explicit Engine(EngineSettings const &settings = {});
   Engine(Engine const &) = delete;
   ~Engine();
 
@@ -51,8 +128,19 @@ public:
   void operator=(Engine) = delete;
 
   void run();
+  // headless only: steps the world and renders frameCount frames on the calling thread
+  void renderFrames(unsigned int const &frameCount);
+  // headless only: pixels of the last rendered frame, as tightly packed BGRA8 rows
+  [[nodiscard]] std::vector<uint8_t> readbackLastFrame();
+  // headless only: draw calls and triangles of the last rendered frame
+  [[nodiscard]] FrameStats getLastFrameStats() const;
 
   [[nodiscard]] bool isRunning();
+  [[nodiscard]] bool isHeadless() const;
+  [[nodiscard]] VkExtent2D getFrameExtent() const;
+
+  void setFramesInFlight(unsigned int const &framesInFlight);
+  [[nodiscard]] unsigned int getFramesInFlight() const;
 
   void loadWorld(World &scene);
   void unloadWorld();
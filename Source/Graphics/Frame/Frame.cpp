@@ -23,6 +23,15 @@ Frame::Frame(GPU const &gpu) : mGPU{gpu} {
   validateVkResult(
       vkAllocateCommandBuffers(gpu.device, &commandBufferAllocateInfo, &commandBuffer));
 
+  // timestamp queries
+  VkQueryPoolCreateInfo queryPoolCreateInfo{};
+  queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  queryPoolCreateInfo.queryCount = TimestampQueryCount;
+
+  validateVkResult(
+      vkCreateQueryPool(gpu.device, &queryPoolCreateInfo, nullptr, &timestampQueryPool));
+
   // sync objects
   VkSemaphoreCreateInfo semaphoreCreateInfo{};
   semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -44,6 +53,7 @@ Frame::~Frame() {
   vkDestroySemaphore(mGPU.device, imageAvailableSemaphore, nullptr);
   vkDestroySemaphore(mGPU.device, renderFinishedSemaphore, nullptr);
   vkDestroyFence(mGPU.device, renderFinishedFence, nullptr);
+  vkDestroyQueryPool(mGPU.device, timestampQueryPool, nullptr);
   vkDestroyCommandPool(mGPU.device, commandPool, nullptr);
 }
 } // namespace flex
\ No newline at end of file
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <vector>
+
 #include "vulkan/vulkan.h"
 
 #include "Graphics/GPU/GPU.hpp"
+#include "Graphics/Memory/Buffer/Buffer.hpp"
 
 namespace cbl::gfx {
 struct Frame {
@@ -16,8 +19,20 @@ public:
   VkCommandPool commandPool{};
   VkCommandBuffer commandBuffer{};
 
+  // begin and end of the scene render pass, read back once the frame's fence is signaled
+  static constexpr uint32_t TimestampQueryCount = 2;
+  VkQueryPool timestampQueryPool{};
+  bool timestampsWritten = false;
+  uint64_t submittedAtNs = 0;
+
+  // buffers replaced while this frame was recorded, destroyed once its fence is signaled
+  std::vector<mem::Buffer> retiredBuffers{};
+
   Frame() = delete;
+  Frame(Frame const &) = delete;
   explicit Frame(GPU const &gpu);
   ~Frame();
+
+  void operator=(Frame const &) = delete;
 };
 } // namespace flex
\ No newline at end of file
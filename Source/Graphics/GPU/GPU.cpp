@@ -1,8 +1,13 @@
 #include "GPU.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <map>
+#include <memory>
 #include <stdexcept>
 
+#include "Core/Files/MappedFile/MappedFile.hpp"
 #include "Graphics/Swapchain/Swapchain.hpp"
 #include "Graphics/Utils/VulkanHelpers.hpp"
 
@@ -38,10 +43,12 @@ QueueFamilyIndices::QueueFamilyIndices(VkPhysicalDevice const &physicalDevice,
       transfer = i;
     }
 
-    VkBool32 surfaceSupported;
-    vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &surfaceSupported);
-    if (surfaceSupported == VK_TRUE && !presentFound) {
-      present = i;
+    if (surface != VK_NULL_HANDLE) {
+      VkBool32 surfaceSupported;
+      vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface, &surfaceSupported);
+      if (surfaceSupported == VK_TRUE && !presentFound) {
+        present = i;
+      }
     }
 
     i++;
@@ -51,37 +58,62 @@ QueueFamilyIndices::QueueFamilyIndices(VkPhysicalDevice const &physicalDevice,
     // graphics queues always support transfer
     transfer = graphics;
   }
+
+  if (surface == VK_NULL_HANDLE) {
+    // nothing is presented, keep the present queue valid
+    present = graphics;
+  }
 }
 
 std::set<uint32_t> QueueFamilyIndices::getUniqueIndices() const {
   return std::set<uint32_t>{graphics, transfer, present};
 }
 
+GPU::GPU() {
+  createInstance(nullptr);
+  selectPhysicalDevice();
+  queueFamilyIndices = QueueFamilyIndices{physicalDevice, renderSurface};
+  createDevice();
+  retrieveQueues();
+  createPipelineCache();
+}
+
 GPU::GPU(Window const &window) {
-  createInstance(window);
+  mRequiredDeviceExtensionsNames.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+
+  createInstance(&window);
   renderSurface = window.getDrawableVulkanSurface(instance);
   selectPhysicalDevice();
   queueFamilyIndices = QueueFamilyIndices{physicalDevice, renderSurface};
   createDevice();
   retrieveQueues();
+  createPipelineCache();
 }
 
 GPU::~GPU() {
+  savePipelineCache();
+  vkDestroyPipelineCache(device, pipelineCache, nullptr);
   vkDestroyDevice(device, nullptr);
-  vkDestroySurfaceKHR(instance, renderSurface, nullptr);
+  if (renderSurface != VK_NULL_HANDLE) {
+    vkDestroySurfaceKHR(instance, renderSurface, nullptr);
+  }
   vkDestroyInstance(instance, nullptr);
 }
 
-void GPU::createInstance(Window const &renderWindow) {
+void GPU::createInstance(Window const *renderWindow) {
   VkApplicationInfo appInfo{};
   appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
   appInfo.pApplicationName = "Cobblestone";
   appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
   appInfo.pEngineName = "Cobblestone";
   appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-  appInfo.apiVersion = VK_API_VERSION_1_0;
+  // 1.1 for vkGetPhysicalDeviceFeatures2, which descriptor indexing features are queried with
+  appInfo.apiVersion = VK_API_VERSION_1_1;
 
-  std::vector<char const *> enabledExtensions = renderWindow.getRequiredVulkanExtensions();
+  std::vector<char const *> enabledExtensions{};
+  if (renderWindow != nullptr) {
+    enabledExtensions = renderWindow->getRequiredVulkanExtensions();
+  }
   std::vector<char const *> enabledLayers{};
 
 #ifndef NDEBUG
@@ -113,7 +145,7 @@ void GPU::selectPhysicalDevice() {
     rankedPhysicalDevices.insert(std::make_pair(deviceScore, availablePhysicalDevice));
   }
 
-  if (rankedPhysicalDevices.rbegin()->first > 0) {
+  if (!rankedPhysicalDevices.empty() && rankedPhysicalDevices.rbegin()->first > 0) {
     physicalDevice = rankedPhysicalDevices.rbegin()->second;
   } else {
     throw std::runtime_error("No suitable device supporting vulkan found");
@@ -140,8 +172,18 @@ void GPU::createDevice() {
   VkPhysicalDeviceFeatures enabledDeviceFeatures{};
   enabledDeviceFeatures.samplerAnisotropy = VK_TRUE;
 
+  VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures{};
+  descriptorIndexingFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+  descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+  descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+  descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+  descriptorIndexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+  descriptorIndexingFeatures.runtimeDescriptorArray = VK_TRUE;
+
   VkDeviceCreateInfo deviceCreateInfo{};
   deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+  deviceCreateInfo.pNext = &descriptorIndexingFeatures;
   deviceCreateInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
   deviceCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
   deviceCreateInfo.enabledExtensionCount =
@@ -158,6 +200,76 @@ void GPU::retrieveQueues() {
   vkGetDeviceQueue(device, queueFamilyIndices.present, 0, &presentQueue);
 }
 
+void GPU::createPipelineCache() {
+  VkPipelineCacheCreateInfo pipelineCacheCreateInfo{};
+  pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+  std::unique_ptr<MappedFile> cacheFile{};
+  std::error_code error{};
+  if (std::filesystem::is_regular_file(PipelineCachePath, error)) {
+    try {
+      cacheFile = std::make_unique<MappedFile>(PipelineCachePath);
+    } catch (std::runtime_error const &) {
+      // an unreadable cache only costs compile time
+    }
+  }
+
+  if (cacheFile && isPipelineCacheCompatible(cacheFile->data(), cacheFile->size())) {
+    pipelineCacheCreateInfo.initialDataSize = cacheFile->size();
+    pipelineCacheCreateInfo.pInitialData = cacheFile->data();
+  }
+
+  validateVkResult(
+      vkCreatePipelineCache(device, &pipelineCacheCreateInfo, nullptr, &pipelineCache));
+}
+
+void GPU::savePipelineCache() const {
+  size_t dataSize = 0;
+  if (vkGetPipelineCacheData(device, pipelineCache, &dataSize, nullptr) != VK_SUCCESS ||
+      dataSize == 0) {
+    return;
+  }
+
+  std::vector<uint8_t> data(dataSize);
+  if (vkGetPipelineCacheData(device, pipelineCache, &dataSize, data.data()) != VK_SUCCESS) {
+    return;
+  }
+
+  // written next to the old cache and swapped in, so a crash never leaves a torn file
+  std::filesystem::path temporaryPath{PipelineCachePath};
+  temporaryPath += ".tmp";
+
+  {
+    std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
+    file.write(reinterpret_cast<char const *>(data.data()), static_cast<std::streamsize>(dataSize));
+    if (!file) {
+      return;
+    }
+  }
+
+  std::error_code error{};
+  std::filesystem::rename(temporaryPath, PipelineCachePath, error);
+}
+
+bool GPU::isPipelineCacheCompatible(uint8_t const *data, std::size_t const &size) const {
+  // header layout from the spec: length, version, vendor id, device id and cache UUID
+  constexpr std::size_t HeaderSize = 4 * sizeof(uint32_t) + VK_UUID_SIZE;
+  if (data == nullptr || size < HeaderSize) {
+    return false;
+  }
+
+  uint32_t header[4];
+  std::memcpy(header, data, sizeof(header));
+
+  VkPhysicalDeviceProperties deviceProperties{};
+  vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+
+  return header[0] >= HeaderSize && header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header[2] == deviceProperties.vendorID && header[3] == deviceProperties.deviceID &&
+         std::memcmp(data + sizeof(header), deviceProperties.pipelineCacheUUID, VK_UUID_SIZE) ==
+             0;
+}
+
 unsigned int GPU::ratePhysicalDevice(VkPhysicalDevice const &physicalDevice,
                                      VkSurfaceKHR const &vulkanSurface,
                                      std::vector<char const *> const &requiredExtensions) {
@@ -175,10 +287,16 @@ unsigned int GPU::ratePhysicalDevice(VkPhysicalDevice const &physicalDevice,
     return 0u;
   }
 
-  if (!physicalDeviceSupportsExtensions(physicalDevice, requiredExtensions)) {
+  if (physicalDeviceProperties.apiVersion < VK_API_VERSION_1_1 ||
+      !physicalDeviceSupportsExtensions(physicalDevice, requiredExtensions) ||
+      !physicalDeviceSupportsBindless(physicalDevice)) {
     return 0u;
   }
 
+  if (vulkanSurface == VK_NULL_HANDLE) {
+    return score;
+  }
+
   if (SwapchainSupportDetails const swapchainSupportDetails{physicalDevice, vulkanSurface};
       !swapchainSupportDetails.isUsable()) {
     return 0u;
@@ -211,6 +329,23 @@ bool GPU::physicalDeviceSupportsExtensions(VkPhysicalDevice const &physicalDevic
   return true;
 }
 
+bool GPU::physicalDeviceSupportsBindless(VkPhysicalDevice const &physicalDevice) {
+  VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptorIndexingFeatures{};
+  descriptorIndexingFeatures.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+  VkPhysicalDeviceFeatures2 features{};
+  features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+  features.pNext = &descriptorIndexingFeatures;
+  vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+  return descriptorIndexingFeatures.shaderSampledImageArrayNonUniformIndexing &&
+         descriptorIndexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+         descriptorIndexingFeatures.descriptorBindingUpdateUnusedWhilePending &&
+         descriptorIndexingFeatures.descriptorBindingPartiallyBound &&
+         descriptorIndexingFeatures.runtimeDescriptorArray;
+}
+
 void GPU::waitIdle() const { validateVkResult(vkDeviceWaitIdle(device)); }
 
 bool GPU::isDedicated() const {
@@ -220,4 +355,40 @@ bool GPU::isDedicated() const {
   return deviceProperties.deviceType & VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU;
 }
 
+bool GPU::isHeadless() const { return renderSurface == VK_NULL_HANDLE; }
+
+float GPU::getTimestampPeriod() const {
+  VkPhysicalDeviceProperties deviceProperties{};
+  vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+
+  uint32_t queueFamilyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> queueFamilies{queueFamilyCount};
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount,
+                                           queueFamilies.data());
+
+  if (queueFamilies[queueFamilyIndices.graphics].timestampValidBits == 0) {
+    return 0.0f;
+  }
+
+  return deviceProperties.limits.timestampPeriod;
+}
+
+uint32_t GPU::getMaxBindlessTextures() const {
+  VkPhysicalDeviceDescriptorIndexingPropertiesEXT descriptorIndexingProperties{};
+  descriptorIndexingProperties.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+  VkPhysicalDeviceProperties2 properties{};
+  properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+  properties.pNext = &descriptorIndexingProperties;
+  vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+  // combined image samplers count against both the sampler and the sampled image limits
+  return std::min({descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers,
+                   descriptorIndexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                   descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+                   descriptorIndexingProperties.maxDescriptorSetUpdateAfterBindSampledImages});
+}
+
 } // namespace cbl::gfx
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <filesystem>
 #include <optional>
 #include <set>
 
@@ -24,13 +25,18 @@ struct QueueFamilyIndices {
 struct GPU {
 private:
   std::vector<const char *> mRequiredDeviceExtensionsNames{
-      VK_KHR_SWAPCHAIN_EXTENSION_NAME,
+      VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME,
   };
 
-  void createInstance(Window const &renderWindow);
+  void createInstance(Window const *renderWindow);
   void selectPhysicalDevice();
   void createDevice();
   void retrieveQueues();
+  void createPipelineCache();
+  void savePipelineCache() const;
+
+  // cache data from another device or driver is ignored instead of handed to the driver
+  [[nodiscard]] bool isPipelineCacheCompatible(uint8_t const *data, std::size_t const &size) const;
 
   [[nodiscard]] static unsigned int
   ratePhysicalDevice(VkPhysicalDevice const &physicalDevice, VkSurfaceKHR const &vulkanSurface,
@@ -38,9 +44,15 @@ private:
   [[nodiscard]] static bool
   physicalDeviceSupportsExtensions(VkPhysicalDevice const &physicalDevice,
                                    std::vector<const char *> const &extensions);
+  // what the bindless texture array needs from descriptor indexing
+  [[nodiscard]] static bool physicalDeviceSupportsBindless(VkPhysicalDevice const &physicalDevice);
 
 public:
-  GPU() = default;
+  // pipeline cache kept between runs, relative to the working directory like the shaders
+  static inline std::filesystem::path const PipelineCachePath{"pipeline_cache.bin"};
+
+  // headless device without surface or swapchain support, for offscreen rendering
+  GPU();
   explicit GPU(Window const &window);
   ~GPU();
 
@@ -54,8 +66,16 @@ public:
   VkQueue transferQueue{};
   VkQueue presentQueue{};
 
+  // shared by every pipeline, seeded from PipelineCachePath and written back on destruction
+  VkPipelineCache pipelineCache{};
+
   void waitIdle() const;
 
   [[nodiscard]] bool isDedicated() const;
+  [[nodiscard]] bool isHeadless() const;
+  // nanoseconds per timestamp query tick, 0 when the graphics queue has no timestamp support
+  [[nodiscard]] float getTimestampPeriod() const;
+  // update after bind sampled images a single shader stage can access
+  [[nodiscard]] uint32_t getMaxBindlessTextures() const;
 };
 } // namespace cbl::gfx
\ No newline at end of file
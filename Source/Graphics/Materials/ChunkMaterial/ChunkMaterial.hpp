@@ -1,15 +1,22 @@
 #pragma once
 
 #include "Graphics/Materials/BaseMaterial.hpp"
+#include "Graphics/TextureRegistry/TextureRegistry.hpp"
 
 namespace cbl::gfx {
 struct ChunkMaterial : public BaseMaterial {
 private:
-  mem::Texture texture{};
+  uint32_t mTextureBase;
 
 public:
+  // baked from the block images by CobblestoneTextureBaker, one layer per block face texture
+  static constexpr char const *BundlePath = "Assets/blocks.cbtx";
+
   ChunkMaterial() = delete;
-  ChunkMaterial(GPU const &gpu, mem::MemoryManager &memoryManager, BaseShader const *shader);
-  ~ChunkMaterial() override;
+  // created before its shader, which needs getTextureBase
+  ChunkMaterial(GPU const &gpu, mem::MemoryManager &memoryManager, TextureRegistry &textures);
+
+  // bindless index of the first block texture layer
+  [[nodiscard]] uint32_t getTextureBase() const;
 };
 } // namespace cbl::gfx
@@ -20,6 +20,7 @@ public:
   VkExtent2D extent{};
   VkImageAspectFlags aspect{};
   uint32_t layers{1};
+  uint32_t mipLevels{1};
 
   static VkFormat findSupportedFormat(GPU const &gpu, std::vector<VkFormat> const &formatChoices,
                                       VkImageTiling const &requestedTiling,
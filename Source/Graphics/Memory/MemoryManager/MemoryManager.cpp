@@ -1,15 +1,21 @@
 #include "MemoryManager.hpp"
 
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <stdexcept>
 #include <thread>
 
 #include "External/stb_image/stb_image.h"
 
+#include "Core/Profiler/Profiler.hpp"
 #include "Graphics/CommandBufferRecorder/CommandBufferRecorder.hpp"
 #include "Graphics/Utils/VulkanHelpers.hpp"
 
 namespace cbl::gfx::mem {
 
-MemoryManager::MemoryManager(GPU const &gpu) : mGPU{gpu} {
+MemoryManager::MemoryManager(GPU const &gpu, ThreadPool &jobs, float const &maxAnisotropy)
+    : mGPU{gpu}, mJobs{jobs}, mMaxAnisotropy{maxAnisotropy} {
 
   VmaAllocatorCreateInfo allocatorCreateInfo{};
   allocatorCreateInfo.instance = mGPU.instance;
@@ -35,11 +41,20 @@ MemoryManager::MemoryManager(GPU const &gpu) : mGPU{gpu} {
 
   validateVkResult(
       vkAllocateCommandBuffers(mGPU.device, &commandBufferAllocateInfo, &mCommandBuffer));
+
+  commandPoolCreateInfo.queueFamilyIndex = mGPU.queueFamilyIndices.graphics;
+  validateVkResult(
+      vkCreateCommandPool(mGPU.device, &commandPoolCreateInfo, nullptr, &mGraphicsCommandPool));
+
+  commandBufferAllocateInfo.commandPool = mGraphicsCommandPool;
+  validateVkResult(
+      vkAllocateCommandBuffers(mGPU.device, &commandBufferAllocateInfo, &mGraphicsCommandBuffer));
 }
 
 MemoryManager::~MemoryManager() {
   mGPU.waitIdle();
   vkDestroyCommandPool(mGPU.device, mCommandPool, nullptr);
+  vkDestroyCommandPool(mGPU.device, mGraphicsCommandPool, nullptr);
   vmaDestroyAllocator(mAllocator);
 }
 
@@ -71,6 +86,34 @@ Buffer MemoryManager::createStagingBuffer(VkDeviceSize const &bufferSize) {
   return stagingBuffer;
 }
 
+Buffer MemoryManager::createReadbackBuffer(VkDeviceSize const &bufferSize) {
+
+  VkBufferCreateInfo bufferCreateInfo{};
+  bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferCreateInfo.size = bufferSize;
+  bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+
+  VmaAllocationCreateInfo allocationCreateInfo{};
+  allocationCreateInfo.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+
+  Buffer readbackBuffer{};
+  allocateBuffer(bufferCreateInfo, allocationCreateInfo, readbackBuffer);
+  return readbackBuffer;
+}
+
+std::vector<uint8_t> MemoryManager::readBuffer(Buffer const &buffer) const {
+  std::vector<uint8_t> data(static_cast<size_t>(buffer.size));
+
+  void *mappedMemory;
+  validateVkResult(vmaMapMemory(mAllocator, buffer.allocation, &mappedMemory));
+  vmaInvalidateAllocation(mAllocator, buffer.allocation, 0, VK_WHOLE_SIZE);
+  memcpy(data.data(), mappedMemory, data.size());
+  vmaUnmapMemory(mAllocator, buffer.allocation);
+
+  return data;
+}
+
 void MemoryManager::destroyBufferOnFenceTrigger(Buffer buffer, VkFence fence) const {
   vkWaitForFences(mGPU.device, 1, &fence, VK_TRUE, UINT64_MAX);
   vkDestroyFence(mGPU.device, fence, nullptr);
@@ -83,6 +126,7 @@ void MemoryManager::destroyBuffer(Buffer &buffer) const {
 }
 
 void MemoryManager::generateMeshBuffer(Mesh &mesh) {
+  CBL_PROFILE_SCOPE("MemoryManager::generateMeshBuffer");
 
   VkBufferCreateInfo bufferCreateInfo{};
   bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -102,6 +146,8 @@ void MemoryManager::generateMeshBuffer(Mesh &mesh) {
 }
 
 void MemoryManager::updateMeshBuffer(Mesh &mesh) {
+  CBL_PROFILE_SCOPE("MemoryManager::updateMeshBuffer");
+
   Buffer stagingBuffer = createStagingBuffer(mesh.getRequiredBufferSize());
 
   void *mappedMemory;
@@ -128,84 +174,234 @@ void MemoryManager::updateMeshBuffer(Mesh &mesh) {
 
 Texture MemoryManager::createTexture(std::vector<std::filesystem::path> const &texturePaths,
                                      bool const &arrayTexture) {
-  std::vector<stbi_uc *> imagesData;
-  imagesData.reserve(texturePaths.size());
+  CBL_PROFILE_SCOPE("MemoryManager::createTexture");
 
-  int maxWidth{}, maxHeight{}, maxChannels{};
+  if (texturePaths.empty()) {
+    throw std::invalid_argument("A texture needs at least one image");
+  }
 
-  for (std::filesystem::path const &path : texturePaths) {
-    int width, height, channels;
-    stbi_uc *pixels = stbi_load(path.string().c_str(), &width, &height, &channels, STBI_rgb_alpha);
+  // headers are enough to size the staging buffer before anything is decoded
+  int width{}, height{};
+  for (std::size_t i = 0; i < texturePaths.size(); i++) {
+    int layerWidth, layerHeight, channels;
+    if (!stbi_info(texturePaths[i].string().c_str(), &layerWidth, &layerHeight, &channels)) {
+      throw std::runtime_error("Failed to load image : " + texturePaths[i].string());
+    }
 
-    if (pixels == nullptr) {
-      throw std::runtime_error("Failed to load image : " + path.string());
+    if (i == 0) {
+      width = layerWidth;
+      height = layerHeight;
+    } else if (layerWidth != width || layerHeight != height) {
+      throw std::invalid_argument("Texture layers must all have the same size : " +
+                                  texturePaths[i].string());
     }
+  }
+
+  // stb_image expands every image to RGBA, whatever channels the file has
+  VkDeviceSize const layerSize = static_cast<VkDeviceSize>(width) * height * STBI_rgb_alpha;
+  Buffer stagingBuffer = createStagingBuffer(layerSize * texturePaths.size());
+
+  void *data;
+  vmaMapMemory(mAllocator, stagingBuffer.allocation, &data);
 
-    maxWidth = std::max(width, maxWidth);
-    maxHeight = std::max(height, maxHeight);
-    maxChannels = std::max(channels, maxChannels);
+  // every layer is decoded on its own worker and copied straight into its slice of staging
+  std::vector<std::future<void>> decodes{};
+  decodes.reserve(texturePaths.size());
+
+  for (std::size_t i = 0; i < texturePaths.size(); i++) {
+    auto *layerData = static_cast<char *>(data) + i * layerSize;
+    std::filesystem::path const &path = texturePaths[i];
+
+    decodes.push_back(mJobs.submit([&path, layerData, layerSize, width, height]() {
+      int layerWidth, layerHeight, channels;
+      stbi_uc *pixels =
+          stbi_load(path.string().c_str(), &layerWidth, &layerHeight, &channels, STBI_rgb_alpha);
+
+      if (pixels == nullptr) {
+        throw std::runtime_error("Failed to load image : " + path.string());
+      }
+
+      // the file may have changed since its header was read
+      bool const sizeMatches = layerWidth == width && layerHeight == height;
+      if (sizeMatches) {
+        memcpy(layerData, pixels, layerSize);
+      }
+      stbi_image_free(pixels);
+
+      if (!sizeMatches) {
+        throw std::runtime_error("Image changed while loading : " + path.string());
+      }
+    }));
+  }
 
-    imagesData.push_back(pixels);
+  // the staging memory stays mapped until every worker is done, even when one of them failed
+  std::exception_ptr decodeFailure{};
+  for (std::future<void> &decode : decodes) {
+    try {
+      decode.get();
+    } catch (...) {
+      if (!decodeFailure) {
+        decodeFailure = std::current_exception();
+      }
+    }
   }
 
-  VkDeviceSize imageSize = maxWidth * maxHeight * maxChannels;
-  VkDeviceSize bufferSize = imageSize * imagesData.size();
+  vmaUnmapMemory(mAllocator, stagingBuffer.allocation);
+
+  if (decodeFailure) {
+    destroyBuffer(stagingBuffer);
+    std::rethrow_exception(decodeFailure);
+  }
 
-  Buffer stagingBuffer = createStagingBuffer(bufferSize);
+  VkExtent2D const extent{static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+  bool const generateMipmaps = supportsMipmapGeneration(VK_FORMAT_R8G8B8A8_SRGB);
+
+  Texture texture{};
+  texture.image = createImage(
+      extent, static_cast<uint32_t>(texturePaths.size()), VK_FORMAT_R8G8B8A8_SRGB,
+      VK_IMAGE_TILING_OPTIMAL,
+      VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+          VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+      VK_IMAGE_ASPECT_COLOR_BIT, arrayTexture ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D,
+      generateMipmaps ? getMipLevelCount(extent) : 1);
+
+  VkBufferImageCopy region{};
+  region.imageSubresource.aspectMask = texture.image.aspect;
+  region.imageSubresource.mipLevel = 0;
+  region.imageSubresource.baseArrayLayer = 0;
+  region.imageSubresource.layerCount = texture.image.layers;
+  region.imageExtent = {texture.image.extent.width, texture.image.extent.height, 1};
+
+  uploadTexture(stagingBuffer, texture.image, {region}, generateMipmaps);
+  texture.sampler = createTextureSampler(texture.image.mipLevels);
+
+  return texture;
+}
+
+Texture MemoryManager::createTexture(TextureBundle const &bundle, bool const &arrayTexture) {
+  CBL_PROFILE_SCOPE("MemoryManager::createTexture");
+
+  Buffer stagingBuffer = createStagingBuffer(bundle.getDataSize());
 
   void *data;
   vmaMapMemory(mAllocator, stagingBuffer.allocation, &data);
-  for (size_t i = 0, offset = 0; i < imagesData.size(); i++, offset += imageSize) {
-    memcpy(static_cast<char *>(data) + offset, imagesData[i], imageSize);
-  }
+  memcpy(data, bundle.getData(), bundle.getDataSize());
   vmaUnmapMemory(mAllocator, stagingBuffer.allocation);
 
+  std::vector<TextureBundle::MipLevel> const &mipLevels = bundle.getMipLevels();
+
   Texture texture{};
-  texture.image = createImage(
-      {static_cast<uint32_t>(maxWidth), static_cast<uint32_t>(maxHeight)},
-      static_cast<uint32_t>(imagesData.size()), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL,
-      VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, VK_IMAGE_ASPECT_COLOR_BIT,
-      arrayTexture ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D);
+  texture.image =
+      createImage(bundle.getExtent(), bundle.getLayerCount(), bundle.getFormat(),
+                  VK_IMAGE_TILING_OPTIMAL,
+                  VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                  VK_IMAGE_ASPECT_COLOR_BIT,
+                  arrayTexture ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D,
+                  static_cast<uint32_t>(mipLevels.size()));
+
+  std::vector<VkBufferImageCopy> regions{};
+  regions.reserve(mipLevels.size());
+
+  for (uint32_t level = 0; level < mipLevels.size(); level++) {
+    VkBufferImageCopy region{};
+    region.bufferOffset = mipLevels[level].offset - mipLevels.front().offset;
+    region.imageSubresource.aspectMask = texture.image.aspect;
+    region.imageSubresource.mipLevel = level;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = texture.image.layers;
+    region.imageExtent = {mipLevels[level].width, mipLevels[level].height, 1};
+
+    regions.push_back(region);
+  }
+
+  uploadTexture(stagingBuffer, texture.image, regions, false);
+  texture.sampler = createTextureSampler(texture.image.mipLevels);
 
+  return texture;
+}
+
+void MemoryManager::uploadTexture(Buffer stagingBuffer, Image const &image,
+                                  std::vector<VkBufferImageCopy> const &regions,
+                                  bool const &generateMipmaps) {
   VkFenceCreateInfo fenceCreateInfo{};
   fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
 
   VkFence transferFinishedFence{};
   validateVkResult(vkCreateFence(mGPU.device, &fenceCreateInfo, nullptr, &transferFinishedFence));
 
-  CommandBufferRecorder recorder{mCommandBuffer};
+  CommandBufferRecorder recorder{generateMipmaps ? mGraphicsCommandBuffer : mCommandBuffer};
   recorder.beginOneTime()
-      .transitionImageLayout(texture.image, VK_IMAGE_LAYOUT_UNDEFINED,
+      .transitionImageLayout(image, VK_IMAGE_LAYOUT_UNDEFINED,
                              VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mGPU.queueFamilyIndices)
-      .copyBufferToImage(stagingBuffer, texture.image)
-      .transitionImageLayout(texture.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                             VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mGPU.queueFamilyIndices)
-      .end()
-      .submit(mGPU.transferQueue, transferFinishedFence);
+      .copyBufferToImage(stagingBuffer, image, regions);
+
+  if (generateMipmaps) {
+    recorder.generateMipmaps(image, mGPU.queueFamilyIndices)
+        .end()
+        .submit(mGPU.graphicsQueue, transferFinishedFence);
+  } else {
+    recorder
+        .transitionImageLayout(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, mGPU.queueFamilyIndices)
+        .end()
+        .submit(mGPU.transferQueue, transferFinishedFence);
+  }
 
   destroyBufferOnFenceTrigger(stagingBuffer, transferFinishedFence);
+}
+
+bool MemoryManager::supportsMipmapGeneration(VkFormat const &format) const {
+  VkFormatProperties formatProperties{};
+  vkGetPhysicalDeviceFormatProperties(mGPU.physicalDevice, format, &formatProperties);
+
+  VkFormatFeatureFlags const requiredFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+                                                VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                                                VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+  return (formatProperties.optimalTilingFeatures & requiredFeatures) == requiredFeatures;
+}
+
+uint32_t MemoryManager::getMipLevelCount(VkExtent2D const &extent) {
+  uint32_t levels = 1;
+  for (uint32_t size = std::max(extent.width, extent.height); size > 1; size /= 2) {
+    levels++;
+  }
+  return levels;
+}
 
+VkSampler MemoryManager::createTextureSampler(uint32_t const &mipLevels) const {
   VkSamplerCreateInfo samplerCreateInfo{};
   samplerCreateInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+  // blocks keep their sharp texels up close, distant ones are filtered across mips
   samplerCreateInfo.magFilter = VK_FILTER_NEAREST;
-  samplerCreateInfo.minFilter = VK_FILTER_NEAREST;
+  samplerCreateInfo.minFilter = VK_FILTER_LINEAR;
   samplerCreateInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
   samplerCreateInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
   samplerCreateInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-  samplerCreateInfo.anisotropyEnable = VK_FALSE;
-  samplerCreateInfo.maxAnisotropy = 0;
+
+  VkPhysicalDeviceProperties deviceProperties{};
+  vkGetPhysicalDeviceProperties(mGPU.physicalDevice, &deviceProperties);
+  float const maxAnisotropy =
+      std::min(mMaxAnisotropy, deviceProperties.limits.maxSamplerAnisotropy);
+
+  // GPU only selects devices supporting samplerAnisotropy and always enables it
+  samplerCreateInfo.anisotropyEnable = maxAnisotropy > 1.0f ? VK_TRUE : VK_FALSE;
+  samplerCreateInfo.maxAnisotropy = std::max(1.0f, maxAnisotropy);
+
   samplerCreateInfo.borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK;
   samplerCreateInfo.unnormalizedCoordinates = VK_FALSE;
-  samplerCreateInfo.compareEnable = VK_TRUE;
-  samplerCreateInfo.compareOp = VK_COMPARE_OP_LESS;
+  // depth comparison is only meaningful for shadow samplers
+  samplerCreateInfo.compareEnable = VK_FALSE;
+  samplerCreateInfo.compareOp = VK_COMPARE_OP_ALWAYS;
   samplerCreateInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
   samplerCreateInfo.mipLodBias = 0.0f;
   samplerCreateInfo.minLod = 0.0f;
-  samplerCreateInfo.maxLod = 0.0f;
+  samplerCreateInfo.maxLod = static_cast<float>(mipLevels);
 
-  validateVkResult(vkCreateSampler(mGPU.device, &samplerCreateInfo, nullptr, &texture.sampler));
+  VkSampler sampler{};
+  validateVkResult(vkCreateSampler(mGPU.device, &samplerCreateInfo, nullptr, &sampler));
 
-  return texture;
+  return sampler;
 }
 
 void MemoryManager::destroyTexture(Texture &texture) {
@@ -217,11 +413,12 @@ Image MemoryManager::createImage(VkExtent2D const &extent, uint32_t const &layer
                                  VkFormat const &format, VkImageTiling const &tiling,
                                  VkImageUsageFlags const &usage,
                                  VkImageAspectFlags const &imageAspect,
-                                 VkImageViewType const &viewType) {
+                                 VkImageViewType const &viewType, uint32_t const &mipLevels) {
   Image image{};
   image.format = format;
   image.extent = extent;
   image.layers = layers;
+  image.mipLevels = mipLevels;
   image.aspect = imageAspect;
 
   // image memory
@@ -231,7 +428,7 @@ Image MemoryManager::createImage(VkExtent2D const &extent, uint32_t const &layer
   imageCreateInfo.extent.width = extent.width;
   imageCreateInfo.extent.height = extent.height;
   imageCreateInfo.extent.depth = 1;
-  imageCreateInfo.mipLevels = 1;
+  imageCreateInfo.mipLevels = mipLevels;
   imageCreateInfo.arrayLayers = layers;
   imageCreateInfo.format = format;
   imageCreateInfo.tiling = tiling;
@@ -261,7 +458,7 @@ void MemoryManager::createImageView(Image &image, VkImageViewType const &viewTyp
   VkImageSubresourceRange subresourceRange{};
   subresourceRange.aspectMask = image.aspect;
   subresourceRange.baseMipLevel = 0;
-  subresourceRange.levelCount = 1;
+  subresourceRange.levelCount = image.mipLevels;
   subresourceRange.baseArrayLayer = 0;
   subresourceRange.layerCount = image.layers;
 
@@ -281,4 +478,10 @@ void MemoryManager::createImageView(Image &image, VkImageViewType const &viewTyp
 
   validateVkResult(vkCreateImageView(mGPU.device, &imageViewCreateInfo, nullptr, &image.imageView));
 }
+
+VmaStats MemoryManager::getAllocationStats() const {
+  VmaStats stats{};
+  vmaCalculateStats(mAllocator, &stats);
+  return stats;
+}
 } // namespace cbl::gfx::mem
\ No newline at end of file
@@ -1,23 +1,34 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <vector>
 
 #include "External/vk_mem_alloc/vk_mem_alloc.h"
 
+#include "Core/Threading/ThreadPool/ThreadPool.hpp"
 #include "Graphics/GPU/GPU.hpp"
 #include "Graphics/Memory/Buffer/Buffer.hpp"
 #include "Graphics/Memory/Image/Image.hpp"
 #include "Graphics/Memory/Texture/Texture.hpp"
+#include "Graphics/Memory/TextureBundle/TextureBundle.hpp"
 #include "Graphics/Mesh/Mesh.hpp"
 
 namespace cbl::gfx::mem {
 struct MemoryManager {
 private:
   GPU const &mGPU;
+  // decodes texture layers, must not be the pool createTexture is called from
+  ThreadPool &mJobs;
   VmaAllocator mAllocator{};
 
   VkCommandPool mCommandPool{};
   VkCommandBuffer mCommandBuffer{};
+  // blits are not available on transfer only queues, mip generation runs on the graphics queue
+  VkCommandPool mGraphicsCommandPool{};
+  VkCommandBuffer mGraphicsCommandBuffer{};
+
+  float mMaxAnisotropy;
 
   void allocateBuffer(VkBufferCreateInfo const &bufferInfo,
                       VmaAllocationCreateInfo const &allocInfo, Buffer &buffer);
@@ -25,26 +36,45 @@ private:
 
   void destroyBufferOnFenceTrigger(Buffer buffer, VkFence fence) const;
 
+  // copies the staging buffer into the image and leaves it ready for sampling, the regions only
+  // cover level 0 when the other levels are generated from it
+  void uploadTexture(Buffer stagingBuffer, Image const &image,
+                     std::vector<VkBufferImageCopy> const &regions, bool const &generateMipmaps);
+  [[nodiscard]] bool supportsMipmapGeneration(VkFormat const &format) const;
+  [[nodiscard]] static uint32_t getMipLevelCount(VkExtent2D const &extent);
+  [[nodiscard]] VkSampler createTextureSampler(uint32_t const &mipLevels) const;
+
 public:
   MemoryManager() = delete;
-  explicit MemoryManager(GPU const &gpu);
+  MemoryManager(GPU const &gpu, ThreadPool &jobs, float const &maxAnisotropy = 1.0f);
   ~MemoryManager();
 
   void destroyBuffer(Buffer &buffer) const;
 
+  // host visible buffer the GPU can copy into, read back with readBuffer
+  [[nodiscard]] Buffer createReadbackBuffer(VkDeviceSize const &bufferSize);
+  [[nodiscard]] std::vector<uint8_t> readBuffer(Buffer const &buffer) const;
+
   void generateMeshBuffer(Mesh &mesh);
   void updateMeshBuffer(Mesh &mesh);
 
+  // decodes the same sized images in parallel into the layers of one texture
   [[nodiscard]] Texture createTexture(std::vector<std::filesystem::path> const &texturePaths,
                                       bool const &arrayTexture);
+  // copies the baked levels straight from the bundle's mapping into staging
+  [[nodiscard]] Texture createTexture(TextureBundle const &bundle, bool const &arrayTexture);
   void destroyTexture(Texture &texture);
 
   [[nodiscard]] Image createImage(VkExtent2D const &extent, uint32_t const &layers,
                                   VkFormat const &format, VkImageTiling const &tiling,
                                   VkImageUsageFlags const &usage,
                                   VkImageAspectFlags const &imageAspect,
-                                  VkImageViewType const &viewType);
+                                  VkImageViewType const &viewType,
+                                  uint32_t const &mipLevels = 1);
   void createImageView(Image &image, VkImageViewType const &viewType) const;
   void destroyImage(Image &image);
+
+  // walks every allocation, too slow to call every frame
+  [[nodiscard]] VmaStats getAllocationStats() const;
 };
 } // namespace cbl::gfx::mem
\ No newline at end of file
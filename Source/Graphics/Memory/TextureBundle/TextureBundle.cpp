@@ -0,0 +1,248 @@
+#include "TextureBundle.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include "External/stb_image/stb_image.h"
+
+namespace cbl::gfx::mem {
+namespace {
+// magic, version, format, layer count and mip level count
+constexpr std::size_t HeaderSize = 5 * sizeof(uint32_t);
+constexpr std::size_t MipLevelSize = 2 * sizeof(uint32_t) + 2 * sizeof(uint64_t);
+// of TextureBundle::Format
+constexpr uint32_t BytesPerPixel = 4;
+
+uint64_t alignUp(uint64_t const &value, uint64_t const &alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+float srgbToLinear(uint8_t const &value) {
+  float const normalized = static_cast<float>(value) / 255.0f;
+  return normalized <= 0.04045f ? normalized / 12.92f
+                                : std::pow((normalized + 0.055f) / 1.055f, 2.4f);
+}
+
+uint8_t linearToSrgb(float const &value) {
+  float const encoded =
+      value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+  return static_cast<uint8_t>(std::clamp(encoded * 255.0f + 0.5f, 0.0f, 255.0f));
+}
+
+// 2x2 box filter, colours are averaged in linear space so mips do not darken
+std::vector<uint8_t> downsample(std::vector<uint8_t> const &pixels, uint32_t const &width,
+                                uint32_t const &height) {
+  static std::array<float, 256> const linear = []() {
+    std::array<float, 256> table{};
+    for (std::size_t i = 0; i < table.size(); i++) {
+      table[i] = srgbToLinear(static_cast<uint8_t>(i));
+    }
+    return table;
+  }();
+
+  uint32_t const mipWidth = std::max(1u, width / 2);
+  uint32_t const mipHeight = std::max(1u, height / 2);
+  std::vector<uint8_t> mip(static_cast<std::size_t>(mipWidth) * mipHeight * BytesPerPixel);
+
+  for (uint32_t y = 0; y < mipHeight; y++) {
+    for (uint32_t x = 0; x < mipWidth; x++) {
+      std::array<float, BytesPerPixel> sum{};
+
+      for (uint32_t sample = 0; sample < 4; sample++) {
+        uint32_t const sourceX = std::min(x * 2 + sample % 2, width - 1);
+        uint32_t const sourceY = std::min(y * 2 + sample / 2, height - 1);
+        uint8_t const *source =
+            &pixels[(static_cast<std::size_t>(sourceY) * width + sourceX) * BytesPerPixel];
+
+        for (uint32_t channel = 0; channel < 3; channel++) {
+          sum[channel] += linear[source[channel]];
+        }
+        sum[3] += static_cast<float>(source[3]);
+      }
+
+      uint8_t *destination = &mip[(static_cast<std::size_t>(y) * mipWidth + x) * BytesPerPixel];
+      for (uint32_t channel = 0; channel < 3; channel++) {
+        destination[channel] = linearToSrgb(sum[channel] / 4.0f);
+      }
+      destination[3] = static_cast<uint8_t>(sum[3] / 4.0f + 0.5f);
+    }
+  }
+
+  return mip;
+}
+} // namespace
+
+TextureBundle::TextureBundle(std::filesystem::path const &path) : mFile{path} {
+  uint8_t const *data = mFile.data();
+  std::size_t const size = mFile.size();
+
+  uint32_t header[5]{};
+  if (size < HeaderSize) {
+    throw std::runtime_error("Invalid texture bundle " + path.string());
+  }
+  std::memcpy(header, data, HeaderSize);
+
+  mFormat = static_cast<VkFormat>(header[2]);
+  mLayerCount = header[3];
+  uint32_t const mipLevelCount = header[4];
+
+  std::size_t const tableEnd = HeaderSize + mipLevelCount * MipLevelSize;
+  if (header[0] != Magic || header[1] != Version || mFormat != Format || mLayerCount == 0 ||
+      mipLevelCount == 0 || mipLevelCount > MaxMipLevels || size < tableEnd) {
+    throw std::runtime_error("Invalid texture bundle " + path.string());
+  }
+
+  mMipLevels.resize(mipLevelCount);
+  uint64_t previousEnd = tableEnd;
+
+  for (uint32_t level = 0; level < mipLevelCount; level++) {
+    uint8_t const *entry = data + HeaderSize + level * MipLevelSize;
+    MipLevel &mipLevel = mMipLevels[level];
+
+    std::memcpy(&mipLevel.width, entry, sizeof(uint32_t));
+    std::memcpy(&mipLevel.height, entry + sizeof(uint32_t), sizeof(uint32_t));
+    std::memcpy(&mipLevel.offset, entry + 2 * sizeof(uint32_t), sizeof(uint64_t));
+    std::memcpy(&mipLevel.layerSize, entry + 2 * sizeof(uint32_t) + sizeof(uint64_t),
+                sizeof(uint64_t));
+
+    // every level halves the previous one down to 1x1, and its layers are exactly as large as
+    // the copies to the GPU read
+    bool validExtent = mipLevel.width != 0 && mipLevel.height != 0;
+    if (level > 0) {
+      MipLevel const &previous = mMipLevels[level - 1];
+      validExtent = (previous.width > 1 || previous.height > 1) &&
+                    mipLevel.width == std::max(1u, previous.width / 2) &&
+                    mipLevel.height == std::max(1u, previous.height / 2);
+    }
+
+    // levels are stored in order, so a truncated or overlapping file is caught here
+    if (!validExtent ||
+        mipLevel.layerSize !=
+            static_cast<uint64_t>(mipLevel.width) * mipLevel.height * BytesPerPixel ||
+        mipLevel.offset % DataAlignment != 0 || mipLevel.offset < previousEnd ||
+        mipLevel.offset > size || mipLevel.layerSize > (size - mipLevel.offset) / mLayerCount) {
+      throw std::runtime_error("Invalid texture bundle " + path.string());
+    }
+
+    previousEnd = mipLevel.offset + mipLevel.layerSize * mLayerCount;
+  }
+}
+
+void TextureBundle::bake(std::vector<std::filesystem::path> const &imagePaths,
+                         std::filesystem::path const &outputPath) {
+  if (imagePaths.empty()) {
+    throw std::invalid_argument("A texture bundle needs at least one image");
+  }
+
+  uint32_t width{}, height{};
+  // levels[level][layer]
+  std::vector<std::vector<std::vector<uint8_t>>> levels{1};
+
+  for (std::filesystem::path const &path : imagePaths) {
+    int imageWidth, imageHeight, channels;
+    stbi_uc *pixels =
+        stbi_load(path.string().c_str(), &imageWidth, &imageHeight, &channels, STBI_rgb_alpha);
+
+    if (pixels == nullptr) {
+      throw std::runtime_error("Failed to load image : " + path.string());
+    }
+
+    std::vector<uint8_t> layer{pixels, pixels + static_cast<std::size_t>(imageWidth) *
+                                                    imageHeight * BytesPerPixel};
+    stbi_image_free(pixels);
+
+    if (levels[0].empty()) {
+      width = static_cast<uint32_t>(imageWidth);
+      height = static_cast<uint32_t>(imageHeight);
+    } else if (static_cast<uint32_t>(imageWidth) != width ||
+               static_cast<uint32_t>(imageHeight) != height) {
+      throw std::invalid_argument("Texture bundle images must all have the same size : " +
+                                  path.string());
+    }
+
+    levels[0].push_back(std::move(layer));
+  }
+
+  std::vector<MipLevel> mipLevels{{width, height, 0, static_cast<uint64_t>(width) * height *
+                                                         BytesPerPixel}};
+
+  while ((mipLevels.back().width > 1 || mipLevels.back().height > 1) &&
+         mipLevels.size() < MaxMipLevels) {
+    MipLevel const &previous = mipLevels.back();
+    std::vector<std::vector<uint8_t>> level{};
+
+    for (std::vector<uint8_t> const &layer : levels.back()) {
+      level.push_back(downsample(layer, previous.width, previous.height));
+    }
+
+    uint32_t const mipWidth = std::max(1u, previous.width / 2);
+    uint32_t const mipHeight = std::max(1u, previous.height / 2);
+    mipLevels.push_back(
+        {mipWidth, mipHeight, 0, static_cast<uint64_t>(mipWidth) * mipHeight * BytesPerPixel});
+    levels.push_back(std::move(level));
+  }
+
+  auto const layerCount = static_cast<uint32_t>(imagePaths.size());
+  auto const mipLevelCount = static_cast<uint32_t>(mipLevels.size());
+
+  uint64_t offset = HeaderSize + mipLevelCount * MipLevelSize;
+  for (MipLevel &mipLevel : mipLevels) {
+    offset = alignUp(offset, DataAlignment);
+    mipLevel.offset = offset;
+    offset += mipLevel.layerSize * layerCount;
+  }
+
+  std::ofstream file{outputPath, std::ios::binary | std::ios::trunc};
+  if (!file) {
+    throw std::runtime_error("Failed to open " + outputPath.string());
+  }
+
+  uint32_t const header[5]{Magic, Version, Format, layerCount, mipLevelCount};
+  file.write(reinterpret_cast<char const *>(header), sizeof(header));
+
+  for (MipLevel const &mipLevel : mipLevels) {
+    file.write(reinterpret_cast<char const *>(&mipLevel.width), sizeof(uint32_t));
+    file.write(reinterpret_cast<char const *>(&mipLevel.height), sizeof(uint32_t));
+    file.write(reinterpret_cast<char const *>(&mipLevel.offset), sizeof(uint64_t));
+    file.write(reinterpret_cast<char const *>(&mipLevel.layerSize), sizeof(uint64_t));
+  }
+
+  for (std::size_t level = 0; level < levels.size(); level++) {
+    std::vector<char> const padding(mipLevels[level].offset - static_cast<uint64_t>(file.tellp()),
+                                    0);
+    file.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+
+    for (std::vector<uint8_t> const &layer : levels[level]) {
+      file.write(reinterpret_cast<char const *>(layer.data()),
+                 static_cast<std::streamsize>(layer.size()));
+    }
+  }
+
+  if (!file) {
+    throw std::runtime_error("Failed to write " + outputPath.string());
+  }
+}
+
+VkFormat TextureBundle::getFormat() const { return mFormat; }
+
+VkExtent2D TextureBundle::getExtent() const {
+  return {mMipLevels.front().width, mMipLevels.front().height};
+}
+
+uint32_t TextureBundle::getLayerCount() const { return mLayerCount; }
+
+std::vector<TextureBundle::MipLevel> const &TextureBundle::getMipLevels() const {
+  return mMipLevels;
+}
+
+uint8_t const *TextureBundle::getData() const { return mFile.data() + mMipLevels.front().offset; }
+
+std::size_t TextureBundle::getDataSize() const {
+  MipLevel const &lastLevel = mMipLevels.back();
+  return lastLevel.offset + lastLevel.layerSize * mLayerCount - mMipLevels.front().offset;
+}
+} // namespace cbl::gfx::mem
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "Core/Files/MappedFile/MappedFile.hpp"
+
+namespace cbl::gfx::mem {
+// texture array baked offline with its whole mip chain, laid out the way it is copied to the GPU
+// header, one MipLevel per level, then the pixels of every level with its layers packed together
+struct TextureBundle {
+public:
+  struct MipLevel {
+    uint32_t width;
+    uint32_t height;
+    // from the start of the file
+    uint64_t offset;
+    uint64_t layerSize;
+  };
+
+  static constexpr uint32_t Magic = 0x58544243; // "CBTX"
+  static constexpr uint32_t Version = 1;
+  // the only format bake writes and the loader accepts
+  static constexpr VkFormat Format = VK_FORMAT_R8G8B8A8_SRGB;
+  // buffer to image copies need offsets aligned to the texel block size
+  static constexpr uint64_t DataAlignment = 16;
+
+private:
+  static constexpr uint32_t MaxMipLevels = 16;
+
+  MappedFile mFile;
+  VkFormat mFormat{};
+  uint32_t mLayerCount{};
+  std::vector<MipLevel> mMipLevels;
+
+public:
+  TextureBundle() = delete;
+  explicit TextureBundle(std::filesystem::path const &path);
+  TextureBundle(TextureBundle const &) = delete;
+  ~TextureBundle() = default;
+
+  void operator=(TextureBundle const &) = delete;
+
+  // decodes same sized images into the layers of an sRGB RGBA8 bundle and generates their mips
+  static void bake(std::vector<std::filesystem::path> const &imagePaths,
+                   std::filesystem::path const &outputPath);
+
+  [[nodiscard]] VkFormat getFormat() const;
+  [[nodiscard]] VkExtent2D getExtent() const;
+  [[nodiscard]] uint32_t getLayerCount() const;
+  [[nodiscard]] std::vector<MipLevel> const &getMipLevels() const;
+
+  // pixels of every level, starting at the first one, ready to be copied into a staging buffer
+  [[nodiscard]] uint8_t const *getData() const;
+  [[nodiscard]] std::size_t getDataSize() const;
+};
+} // namespace cbl::gfx::mem
@@ -1,5 +1,7 @@
 #include "Mesh.hpp"
 
+#include <utility>
+
 #include "Graphics/Memory/MemoryManager/MemoryManager.hpp"
 
 namespace cbl::gfx {
@@ -8,6 +10,13 @@ Mesh::Mesh(std::vector<uint32_t> const &indices, std::vector<Vertex> const &vert
   this->vertices = vertices;
 }
 
+Mesh::Mesh(MeshData &&data) : indices{std::move(data.indices)}, position{data.position} {
+  vertices.reserve(data.vertices.size());
+  for (MeshVertex const &vertex : data.vertices) {
+    vertices.push_back(Vertex{vertex.position, vertex.uvw});
+  }
+}
+
 size_t Mesh::getIndicesSize() const { return sizeof(indices[0]) * indices.size(); }
 size_t Mesh::getVerticesSize() const { return sizeof(vertices[0]) * vertices.size(); }
 size_t Mesh::getRequiredBufferSize() const { return getIndicesSize() + getVerticesSize(); }
@@ -2,12 +2,15 @@
 
 #include <vector>
 
+#include "Game/MeshData/MeshData.hpp"
 #include "Graphics/Memory/Buffer/Buffer.hpp"
 #include "Graphics/Vertex/Vertex.hpp"
 
 namespace cbl::gfx {
 struct Mesh {
   explicit Mesh(std::vector<uint32_t> const &indices, std::vector<Vertex> const &vertices);
+  // takes the indices and converts the vertices of a mesh built by the world
+  explicit Mesh(MeshData &&data);
 
   std::vector<uint32_t> indices{};
   std::vector<Vertex> vertices{};
@@ -0,0 +1,88 @@
+#include "OffscreenTarget.hpp"
+
+#include <array>
+
+#include "Graphics/CommandBufferRecorder/CommandBufferRecorder.hpp"
+#include "Graphics/Swapchain/Swapchain.hpp"
+#include "Graphics/Utils/VulkanHelpers.hpp"
+
+namespace cbl::gfx {
+
+OffscreenTarget::OffscreenTarget(GPU const &gpu, mem::MemoryManager &memoryManager,
+                                 VkExtent2D const &extent, uint32_t const &imageCount)
+    : mMemoryManager{memoryManager}, mGPU{gpu} {
+  VkFormat const depthFormat = Swapchain::getSupportedDepthBufferFormat(mGPU);
+
+  renderPass = createSceneRenderPass(mGPU.device, ColorFormat, depthFormat,
+                                     VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+
+  frameBufferImages.reserve(imageCount);
+  for (uint32_t i = 0; i < imageCount; i++) {
+    frameBufferImages.push_back(mMemoryManager.createImage(
+        extent, 1, ColorFormat, VK_IMAGE_TILING_OPTIMAL,
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_VIEW_TYPE_2D));
+  }
+
+  depthBufferImage = mMemoryManager.createImage(
+      extent, 1, depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+      VK_IMAGE_ASPECT_DEPTH_BIT, VK_IMAGE_VIEW_TYPE_2D);
+
+  framebuffers.resize(frameBufferImages.size());
+
+  for (size_t i = 0; i < framebuffers.size(); i++) {
+    std::array<VkImageView, 2> attachments{frameBufferImages[i].imageView,
+                                           depthBufferImage.imageView};
+
+    VkFramebufferCreateInfo framebufferCreateInfo{};
+    framebufferCreateInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebufferCreateInfo.renderPass = renderPass;
+    framebufferCreateInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+    framebufferCreateInfo.pAttachments = attachments.data();
+    framebufferCreateInfo.width = extent.width;
+    framebufferCreateInfo.height = extent.height;
+    framebufferCreateInfo.layers = 1;
+
+    validateVkResult(
+        vkCreateFramebuffer(mGPU.device, &framebufferCreateInfo, nullptr, &framebuffers[i]));
+  }
+}
+
+OffscreenTarget::~OffscreenTarget() {
+  mGPU.waitIdle();
+
+  for (VkFramebuffer const &framebuffer : framebuffers) {
+    vkDestroyFramebuffer(mGPU.device, framebuffer, nullptr);
+  }
+
+  for (mem::Image &image : frameBufferImages) {
+    mMemoryManager.destroyImage(image);
+  }
+  mMemoryManager.destroyImage(depthBufferImage);
+
+  vkDestroyRenderPass(mGPU.device, renderPass, nullptr);
+}
+
+float OffscreenTarget::getAspectRatio() const {
+  return static_cast<float>(frameBufferImages[0].extent.width) /
+         static_cast<float>(frameBufferImages[0].extent.height);
+}
+
+std::vector<uint8_t> OffscreenTarget::readback(uint32_t const &imageIndex,
+                                               VkCommandBuffer &commandBuffer,
+                                               VkQueue const &queue) {
+  mem::Image const &image = frameBufferImages[imageIndex];
+  // 4 bytes per texel for ColorFormat
+  mem::Buffer readbackBuffer = mMemoryManager.createReadbackBuffer(
+      static_cast<VkDeviceSize>(image.extent.width) * image.extent.height * 4);
+
+  CommandBufferRecorder recorder{commandBuffer};
+  recorder.beginOneTime().copyImageToBuffer(image, readbackBuffer).end().submit(queue);
+  validateVkResult(vkQueueWaitIdle(queue));
+
+  std::vector<uint8_t> pixels = mMemoryManager.readBuffer(readbackBuffer);
+  mMemoryManager.destroyBuffer(readbackBuffer);
+
+  return pixels;
+}
+} // namespace cbl::gfx
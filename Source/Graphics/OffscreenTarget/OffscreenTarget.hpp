@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "Graphics/GPU/GPU.hpp"
+#include "Graphics/Memory/Image/Image.hpp"
+#include "Graphics/Memory/MemoryManager/MemoryManager.hpp"
+
+namespace cbl::gfx {
+// Swapchain stand-in for headless rendering: same render pass layout, images stay on the GPU
+struct OffscreenTarget {
+private:
+  mem::MemoryManager &mMemoryManager;
+  GPU const &mGPU;
+
+public:
+  static constexpr VkFormat ColorFormat = VK_FORMAT_B8G8R8A8_SRGB;
+
+  VkRenderPass renderPass{};
+  std::vector<mem::Image> frameBufferImages{};
+  mem::Image depthBufferImage{};
+  std::vector<VkFramebuffer> framebuffers{};
+
+  OffscreenTarget() = delete;
+  OffscreenTarget(OffscreenTarget const &) = delete;
+  OffscreenTarget(GPU const &gpu, mem::MemoryManager &memoryManager, VkExtent2D const &extent,
+                  uint32_t const &imageCount);
+  ~OffscreenTarget();
+
+  void operator=(OffscreenTarget const &) = delete;
+
+  [[nodiscard]] float getAspectRatio() const;
+
+  // copies a finished image to host memory as tightly packed BGRA8 rows, the image must not be
+  // in use by the GPU
+  [[nodiscard]] std::vector<uint8_t> readback(uint32_t const &imageIndex,
+                                              VkCommandBuffer &commandBuffer,
+                                              VkQueue const &queue);
+};
+} // namespace cbl::gfx
@@ -0,0 +1,94 @@
+#include "ProfilerPanel.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <utility>
+
+#include "External/imgui/imgui.h"
+
+#include "Core/Profiler/Profiler.hpp"
+
+namespace cbl::gfx {
+namespace {
+struct ScopeStats {
+  unsigned int calls = 0;
+  uint64_t totalNs = 0;
+  uint64_t maxNs = 0;
+};
+
+using ScopeKey = std::pair<uint32_t, char const *>;
+
+// scope names are compared by content, the same name may be at several addresses
+struct ScopeKeyLess {
+  bool operator()(ScopeKey const &a, ScopeKey const &b) const {
+    return a.first != b.first ? a.first < b.first : std::strcmp(a.second, b.second) < 0;
+  }
+};
+
+using ScopeMap = std::map<ScopeKey, ScopeStats, ScopeKeyLess,
+                          FrameAllocator<std::pair<ScopeKey const, ScopeStats>>>;
+} // namespace
+
+void ProfilerPanel::draw(FrameArena &arena) {
+  // statistics over the last second
+  uint64_t const nowNs = Profiler::nowNs();
+  uint64_t const windowStartNs = nowNs - std::min<uint64_t>(nowNs, 1'000'000'000);
+  ScopeMap scopes{ScopeMap::allocator_type{arena}};
+
+  for (ProfileEvent const &event : Profiler::getEvents(arena)) {
+    if (event.startNs < windowStartNs) {
+      continue;
+    }
+
+    ScopeStats &stats = scopes[std::make_pair(event.threadId, event.name)];
+    stats.calls++;
+    stats.totalNs += event.durationNs;
+    stats.maxNs = std::max(stats.maxNs, event.durationNs);
+  }
+
+  ImGui::Begin("Profiler");
+
+  if constexpr (!Profiler::Enabled) {
+    ImGui::Text("CPU markers are compiled out, configure with COBBLESTONE_PROFILING=ON");
+  }
+
+  if (ImGui::Button("Export Chrome trace")) {
+    Profiler::writeChromeTrace("cobblestone_trace.json");
+  }
+
+  ImGui::Columns(5, "profilerScopes");
+  ImGui::Text("Thread");
+  ImGui::NextColumn();
+  ImGui::Text("Scope");
+  ImGui::NextColumn();
+  ImGui::Text("Calls/s");
+  ImGui::NextColumn();
+  ImGui::Text("Avg ms");
+  ImGui::NextColumn();
+  ImGui::Text("Max ms");
+  ImGui::NextColumn();
+  ImGui::Separator();
+
+  for (auto const &[key, stats] : scopes) {
+    if (char const *threadName = Profiler::getThreadName(key.first); threadName != nullptr) {
+      ImGui::Text("%s", threadName);
+    } else {
+      ImGui::Text("Thread %u", key.first);
+    }
+    ImGui::NextColumn();
+    ImGui::Text("%s", key.second);
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.calls);
+    ImGui::NextColumn();
+    ImGui::Text("%.3f", static_cast<double>(stats.totalNs) / stats.calls / 1'000'000.0);
+    ImGui::NextColumn();
+    ImGui::Text("%.3f", static_cast<double>(stats.maxNs) / 1'000'000.0);
+    ImGui::NextColumn();
+  }
+
+  ImGui::Columns(1);
+  ImGui::End();
+}
+} // namespace cbl::gfx
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "Core/Memory/FrameArena/FrameArena.hpp"
+
+namespace cbl::gfx {
+// ImGui window with per scope statistics of the recorded profiler events
+struct ProfilerPanel {
+public:
+  ProfilerPanel() = delete;
+
+  // the statistics are gathered in arena, which must outlive the ImGui frame
+  static void draw(FrameArena &arena);
+};
+} // namespace cbl::gfx
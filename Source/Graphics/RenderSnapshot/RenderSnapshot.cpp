@@ -0,0 +1,48 @@
+#include "RenderSnapshot.hpp"
+
+#include <cstring>
+
+namespace cbl::gfx {
+namespace {
+// unlike ImVector::operator=, keeps the destination's memory when it is large enough
+template <typename T> void copyInto(ImVector<T> &destination, ImVector<T> const &source) {
+  destination.resize(source.Size);
+  if (source.Size > 0) {
+    std::memcpy(destination.Data, source.Data, source.size_in_bytes());
+  }
+}
+} // namespace
+
+ImGuiDrawSnapshot::~ImGuiDrawSnapshot() {
+  for (ImDrawList *drawList : mDrawLists) {
+    IM_DELETE(drawList);
+  }
+}
+
+void ImGuiDrawSnapshot::capture(ImDrawData const *source) {
+  clear();
+
+  if (source == nullptr || !source->Valid) {
+    return;
+  }
+
+  for (int i = 0; i < source->CmdListsCount; i++) {
+    ImDrawList const &sourceList = *source->CmdLists[i];
+
+    if (static_cast<std::size_t>(i) == mDrawLists.size()) {
+      mDrawLists.push_back(IM_NEW(ImDrawList)(sourceList._Data));
+    }
+
+    ImDrawList &drawList = *mDrawLists[static_cast<std::size_t>(i)];
+    copyInto(drawList.CmdBuffer, sourceList.CmdBuffer);
+    copyInto(drawList.IdxBuffer, sourceList.IdxBuffer);
+    copyInto(drawList.VtxBuffer, sourceList.VtxBuffer);
+    drawList.Flags = sourceList.Flags;
+  }
+
+  drawData = *source;
+  drawData.CmdLists = mDrawLists.data();
+}
+
+void ImGuiDrawSnapshot::clear() { drawData.Clear(); }
+} // namespace cbl::gfx
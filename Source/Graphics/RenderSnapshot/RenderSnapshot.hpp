@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "External/imgui/imgui.h"
+
+#include "Graphics/Camera/Camera.hpp"
+#include "Graphics/Materials/BaseMaterial.hpp"
+#include "Graphics/Shaders/BaseShader.hpp"
+#include "Game/MeshData/MeshData.hpp"
+
+namespace cbl::gfx {
+// Mesh data handed from the simulation thread to the render thread, which owns the GPU copies
+struct MeshChange {
+  enum class Type { eUpload, eDestroy };
+
+  Type type{Type::eUpload};
+  std::size_t meshId{};
+  MeshData mesh{};
+};
+
+// Deep copy of the ImGui draw data, so the next ImGui frame can start while this one renders
+// the draw lists and their buffers are kept between captures, so once they are large enough
+// capturing no longer allocates
+struct ImGuiDrawSnapshot {
+private:
+  std::vector<ImDrawList *> mDrawLists{};
+
+public:
+  ImDrawData drawData{};
+
+  ImGuiDrawSnapshot() = default;
+  ImGuiDrawSnapshot(ImGuiDrawSnapshot const &) = delete;
+  ~ImGuiDrawSnapshot();
+
+  void operator=(ImGuiDrawSnapshot const &) = delete;
+
+  void capture(ImDrawData const *source);
+  // empties the draw data, keeping the draw lists for the next capture
+  void clear();
+};
+
+struct RenderSnapshot {
+  CameraState camera{};
+  std::vector<std::size_t> visibleMeshes{};
+  std::vector<BaseShader const *> shaders{};
+  std::vector<BaseMaterial const *> materials{};
+  ImGuiDrawSnapshot imgui{};
+};
+} // namespace cbl::gfx
@@ -1,31 +1,28 @@
 #include "BaseShader.hpp"
 
 #include <array>
-#include <fstream>
+#include <chrono>
 
+#include "Core/Files/MappedFile/MappedFile.hpp"
+#include "Core/Profiler/Profiler.hpp"
 #include "Graphics/Utils/VulkanHelpers.hpp"
 
 namespace cbl::gfx {
-BaseShader::BaseShader(GPU const &gpu, VkRenderPass const &renderPass) : mGPU{gpu} {}
+BaseShader::BaseShader(GPU const &gpu, VkRenderPass const &renderPass, ThreadPool &jobs)
+    : mGPU{gpu}, mJobs{jobs} {}
 
 VkShaderModule BaseShader::createShaderModule(std::filesystem::path const &path) const {
-  std::ifstream shaderFile{path.string(), std::ios::ate | std::ios::binary};
+  // mappings are page aligned, which satisfies the alignment SPIR-V code needs
+  MappedFile const shaderFile{path};
 
-  if (!shaderFile.is_open()) {
-    throw std::runtime_error{"Failed to open file " + path.string()};
+  if (shaderFile.size() == 0 || shaderFile.size() % sizeof(uint32_t) != 0) {
+    throw std::runtime_error{"Invalid SPIR-V file " + path.string()};
   }
 
-  std::streamsize const fileSize = shaderFile.tellg();
-  std::vector<char> buffer(static_cast<size_t>(fileSize));
-
-  shaderFile.seekg(0);
-  shaderFile.read(buffer.data(), fileSize);
-  shaderFile.close();
-
   VkShaderModuleCreateInfo shaderModuleCreateInfo{};
   shaderModuleCreateInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-  shaderModuleCreateInfo.codeSize = static_cast<uint32_t>(buffer.size());
-  shaderModuleCreateInfo.pCode = reinterpret_cast<const uint32_t *>(buffer.data());
+  shaderModuleCreateInfo.codeSize = shaderFile.size();
+  shaderModuleCreateInfo.pCode = reinterpret_cast<const uint32_t *>(shaderFile.data());
 
   VkShaderModule shaderModule{};
   validateVkResult(
@@ -42,9 +39,23 @@ void BaseShader::createDefaultPipelineLayout() {
       vkCreatePipelineLayout(mGPU.device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout));
 }
 
-void BaseShader::createDefaultPipeline(VkRenderPass const &renderPass) {
+void BaseShader::createDefaultPipeline(VkRenderPass const &renderPass,
+                                       std::vector<uint32_t> vertexConstants) {
+  // the name is virtual, so it is resolved here rather than on the worker
   std::filesystem::path shaderPath{"Shaders/" + getName() + "/" + getName()};
 
+  std::future<void> creation =
+      mJobs.submit([this, renderPass, shaderPath, vertexConstants = std::move(vertexConstants)]() {
+        buildDefaultPipeline(renderPass, shaderPath, vertexConstants);
+      });
+  mPipelineCreation = creation.share();
+}
+
+void BaseShader::buildDefaultPipeline(VkRenderPass const &renderPass,
+                                      std::filesystem::path const &shaderPath,
+                                      std::vector<uint32_t> const &vertexConstants) {
+  CBL_PROFILE_SCOPE("BaseShader::buildDefaultPipeline");
+
   VkShaderModule vertShaderModule = createShaderModule({shaderPath.string() + ".vert.spv"});
   VkShaderModule fragShaderModule = createShaderModule({shaderPath.string() + ".frag.spv"});
 
@@ -54,6 +65,20 @@ void BaseShader::createDefaultPipeline(VkRenderPass const &renderPass) {
   shaderStages[0].module = vertShaderModule;
   shaderStages[0].pName = "main";
 
+  std::vector<VkSpecializationMapEntry> vertexConstantEntries(vertexConstants.size());
+  for (std::size_t i = 0; i < vertexConstantEntries.size(); i++) {
+    vertexConstantEntries[i].constantID = static_cast<uint32_t>(i);
+    vertexConstantEntries[i].offset = static_cast<uint32_t>(i * sizeof(uint32_t));
+    vertexConstantEntries[i].size = sizeof(uint32_t);
+  }
+
+  VkSpecializationInfo vertexSpecialization{};
+  vertexSpecialization.mapEntryCount = static_cast<uint32_t>(vertexConstantEntries.size());
+  vertexSpecialization.pMapEntries = vertexConstantEntries.data();
+  vertexSpecialization.dataSize = vertexConstants.size() * sizeof(uint32_t);
+  vertexSpecialization.pData = vertexConstants.data();
+  shaderStages[0].pSpecializationInfo = vertexConstants.empty() ? nullptr : &vertexSpecialization;
+
   shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
   shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
   shaderStages[1].module = fragShaderModule;
@@ -153,17 +178,39 @@ void BaseShader::createDefaultPipeline(VkRenderPass const &renderPass) {
   pipelineCreateInfo.subpass = 0;
   pipelineCreateInfo.basePipelineIndex = -1;
 
-  validateVkResult(
-      vkCreateGraphicsPipelines(mGPU.device, nullptr, 1, &pipelineCreateInfo, nullptr, &pipeline));
+  validateVkResult(vkCreateGraphicsPipelines(mGPU.device, mGPU.pipelineCache, 1,
+                                             &pipelineCreateInfo, nullptr, &pipeline));
 
   vkDestroyShaderModule(mGPU.device, vertShaderModule, nullptr);
   vkDestroyShaderModule(mGPU.device, fragShaderModule, nullptr);
 }
+
 BaseShader::~BaseShader() {
+  // the worker may still be writing the pipeline
+  if (mPipelineCreation.valid()) {
+    mPipelineCreation.wait();
+  }
+
   vkDestroyDescriptorPool(mGPU.device, descriptorPool, nullptr);
   vkDestroyDescriptorSetLayout(mGPU.device, descriptorSetLayout, nullptr);
   vkDestroyPipeline(mGPU.device, pipeline, nullptr);
   vkDestroyPipelineLayout(mGPU.device, pipelineLayout, nullptr);
 }
 
+bool BaseShader::isPipelineReady() const {
+  if (!mPipelineCreation.valid() ||
+      mPipelineCreation.wait_for(std::chrono::seconds{0}) != std::future_status::ready) {
+    return false;
+  }
+
+  mPipelineCreation.get();
+  return true;
+}
+
+void BaseShader::waitForPipeline() const {
+  if (mPipelineCreation.valid()) {
+    mPipelineCreation.get();
+  }
+}
+
 } // namespace cbl::gfx
@@ -2,10 +2,13 @@
 
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <string>
+#include <vector>
 
 #include <vulkan/vulkan.h>
 
+#include "Core/Threading/ThreadPool/ThreadPool.hpp"
 #include "Graphics/GPU/GPU.hpp"
 #include "Graphics/Memory/MemoryManager/MemoryManager.hpp"
 #include "Graphics/Memory/Texture/Texture.hpp"
@@ -14,13 +17,21 @@ namespace cbl::gfx {
 
 struct BaseShader {
 private:
+  std::shared_future<void> mPipelineCreation;
+
   [[nodiscard]] VkShaderModule createShaderModule(std::filesystem::path const &path) const;
+  void buildDefaultPipeline(VkRenderPass const &renderPass, std::filesystem::path const &shaderPath,
+                            std::vector<uint32_t> const &vertexConstants);
 
 protected:
   GPU const &mGPU;
+  ThreadPool &mJobs;
 
   void createDefaultPipelineLayout();
-  void createDefaultPipeline(VkRenderPass const &renderPass);
+  // builds the pipeline on a worker, the layout has to exist before this is called
+  // vertexConstants[i] specializes constant_id i of the vertex shader
+  void createDefaultPipeline(VkRenderPass const &renderPass,
+                             std::vector<uint32_t> vertexConstants = {});
 
 public:
   VkPipeline pipeline{};
@@ -30,9 +41,13 @@ public:
   VkDescriptorPool descriptorPool{};
 
   BaseShader() = delete;
-  BaseShader(GPU const &gpu, VkRenderPass const &renderPass);
+  BaseShader(GPU const &gpu, VkRenderPass const &renderPass, ThreadPool &jobs);
   virtual ~BaseShader();
 
+  // rethrows on the calling thread if creating the pipeline failed
+  [[nodiscard]] bool isPipelineReady() const;
+  void waitForPipeline() const;
+
   [[nodiscard]] virtual std::string getName() = 0;
 };
 } // namespace cbl::gfx
\ No newline at end of file
@@ -1,13 +1,17 @@
 #pragma once
 
 #include "Graphics/Shaders/BaseShader.hpp"
+#include "Graphics/TextureRegistry/TextureRegistry.hpp"
 
 namespace cbl::gfx {
 struct ChunkShader : public BaseShader {
 private:
 public:
   ChunkShader() = delete;
-  ChunkShader(GPU const &gpu, VkRenderPass const &renderPass);
+  // textureBase is the bindless index of the first block texture, the block vertices only store
+  // the layer of their face
+  ChunkShader(GPU const &gpu, VkRenderPass const &renderPass, ThreadPool &jobs,
+              TextureRegistry const &textures, uint32_t const &textureBase);
 
   [[nodiscard]] std::string getName() override;
 };
@@ -37,7 +37,6 @@ private:
 
   [[nodiscard]] static VkSurfaceFormatKHR
   getSupportedSwapchainSurfaceFormat(SwapchainSupportDetails const &swapchainSupportDetails);
-  [[nodiscard]] static VkFormat getSupportedDepthBufferFormat(GPU const &gpu);
 
   void createRenderPass();
 
@@ -57,6 +56,8 @@ public:
   Swapchain(GPU const &gpu, Window const &window, mem::MemoryManager &memoryManager);
   ~Swapchain();
 
+  [[nodiscard]] static VkFormat getSupportedDepthBufferFormat(GPU const &gpu);
+
   void handleFrameBufferResize(Window const &window);
 
   [[nodiscard]] float getAspectRatio() const;
@@ -0,0 +1,150 @@
+#include "TextureRegistry.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "Graphics/Utils/VulkanHelpers.hpp"
+
+namespace cbl::gfx {
+TextureRegistry::TextureRegistry(GPU const &gpu, mem::MemoryManager &memoryManager)
+    : mGPU{gpu}, mMemoryManager{memoryManager},
+      mCapacity{std::min(MaxTextures, gpu.getMaxBindlessTextures())} {
+
+  VkDescriptorSetLayoutBinding texturesBinding{};
+  texturesBinding.binding = Binding;
+  texturesBinding.descriptorCount = mCapacity;
+  texturesBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  texturesBinding.pImmutableSamplers = nullptr;
+  texturesBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+  // unused slots may stay empty and new textures can be written while frames are in flight
+  VkDescriptorBindingFlagsEXT const bindingFlags =
+      VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+      VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+      VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+
+  VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCreateInfo{};
+  bindingFlagsCreateInfo.sType =
+      VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+  bindingFlagsCreateInfo.bindingCount = 1;
+  bindingFlagsCreateInfo.pBindingFlags = &bindingFlags;
+
+  VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo{};
+  descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+  descriptorSetLayoutCreateInfo.pNext = &bindingFlagsCreateInfo;
+  descriptorSetLayoutCreateInfo.flags =
+      VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+  descriptorSetLayoutCreateInfo.bindingCount = 1;
+  descriptorSetLayoutCreateInfo.pBindings = &texturesBinding;
+
+  validateVkResult(vkCreateDescriptorSetLayout(mGPU.device, &descriptorSetLayoutCreateInfo, nullptr,
+                                               &mDescriptorSetLayout));
+
+  VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, mCapacity};
+
+  VkDescriptorPoolCreateInfo descriptorPoolCreateInfo{};
+  descriptorPoolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+  descriptorPoolCreateInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+  descriptorPoolCreateInfo.poolSizeCount = 1;
+  descriptorPoolCreateInfo.pPoolSizes = &poolSize;
+  descriptorPoolCreateInfo.maxSets = 1;
+  validateVkResult(
+      vkCreateDescriptorPool(mGPU.device, &descriptorPoolCreateInfo, nullptr, &mDescriptorPool));
+
+  VkDescriptorSetAllocateInfo allocateInfo{};
+  allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+  allocateInfo.descriptorPool = mDescriptorPool;
+  allocateInfo.descriptorSetCount = 1;
+  allocateInfo.pSetLayouts = &mDescriptorSetLayout;
+  validateVkResult(vkAllocateDescriptorSets(mGPU.device, &allocateInfo, &mDescriptorSet));
+}
+
+TextureRegistry::~TextureRegistry() {
+  clear();
+  vkDestroyDescriptorPool(mGPU.device, mDescriptorPool, nullptr);
+  vkDestroyDescriptorSetLayout(mGPU.device, mDescriptorSetLayout, nullptr);
+}
+
+uint32_t TextureRegistry::writeDescriptor(VkImageView const &imageView, VkSampler const &sampler) {
+  if (mTextureCount >= mCapacity) {
+    throw std::out_of_range("Too many textures registered");
+  }
+
+  VkDescriptorImageInfo imageInfo{};
+  imageInfo.imageView = imageView;
+  imageInfo.sampler = sampler;
+  imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  VkWriteDescriptorSet writeDescriptorSet{};
+  writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  writeDescriptorSet.dstSet = mDescriptorSet;
+  writeDescriptorSet.dstBinding = Binding;
+  writeDescriptorSet.dstArrayElement = mTextureCount;
+  writeDescriptorSet.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+  writeDescriptorSet.descriptorCount = 1;
+  writeDescriptorSet.pImageInfo = &imageInfo;
+  vkUpdateDescriptorSets(mGPU.device, 1, &writeDescriptorSet, 0, nullptr);
+
+  return mTextureCount++;
+}
+
+uint32_t TextureRegistry::registerTexture(mem::Texture const &texture) {
+  mTextures.push_back(texture);
+  return writeDescriptor(texture.image.imageView, texture.sampler);
+}
+
+uint32_t TextureRegistry::registerTextureLayers(mem::Texture const &arrayTexture) {
+  if (mTextureCount + arrayTexture.image.layers > mCapacity) {
+    throw std::out_of_range("Too many textures registered");
+  }
+
+  mTextures.push_back(arrayTexture);
+  uint32_t const firstIndex = mTextureCount;
+
+  for (uint32_t layer = 0; layer < arrayTexture.image.layers; layer++) {
+    VkImageViewCreateInfo imageViewCreateInfo{};
+    imageViewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    imageViewCreateInfo.image = arrayTexture.image.image;
+    imageViewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    imageViewCreateInfo.format = arrayTexture.image.format;
+    imageViewCreateInfo.subresourceRange.aspectMask = arrayTexture.image.aspect;
+    imageViewCreateInfo.subresourceRange.baseMipLevel = 0;
+    imageViewCreateInfo.subresourceRange.levelCount = arrayTexture.image.mipLevels;
+    imageViewCreateInfo.subresourceRange.baseArrayLayer = layer;
+    imageViewCreateInfo.subresourceRange.layerCount = 1;
+
+    VkImageView layerView{};
+    validateVkResult(vkCreateImageView(mGPU.device, &imageViewCreateInfo, nullptr, &layerView));
+    mLayerViews.push_back(layerView);
+
+    writeDescriptor(layerView, arrayTexture.sampler);
+  }
+
+  return firstIndex;
+}
+
+void TextureRegistry::clear() {
+  for (VkImageView const &layerView : mLayerViews) {
+    vkDestroyImageView(mGPU.device, layerView, nullptr);
+  }
+  mLayerViews.clear();
+
+  for (mem::Texture &texture : mTextures) {
+    mMemoryManager.destroyTexture(texture);
+  }
+  mTextures.clear();
+
+  // stale descriptors are never read, partially bound slots only need to be valid when used
+  mTextureCount = 0;
+}
+
+VkDescriptorSetLayout TextureRegistry::getDescriptorSetLayout() const {
+  return mDescriptorSetLayout;
+}
+
+VkDescriptorSet TextureRegistry::getDescriptorSet() const { return mDescriptorSet; }
+
+uint32_t TextureRegistry::getTextureCount() const { return mTextureCount; }
+
+uint32_t TextureRegistry::getCapacity() const { return mCapacity; }
+} // namespace cbl::gfx
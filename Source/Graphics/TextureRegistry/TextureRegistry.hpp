@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <vulkan/vulkan.h>
+
+#include "Graphics/GPU/GPU.hpp"
+#include "Graphics/Memory/MemoryManager/MemoryManager.hpp"
+#include "Graphics/Memory/Texture/Texture.hpp"
+
+namespace cbl::gfx {
+// every texture lives in one update after bind descriptor array, shaders pick them by index, so
+// registering textures never adds descriptor sets, pools or binds
+struct TextureRegistry {
+private:
+  GPU const &mGPU;
+  mem::MemoryManager &mMemoryManager;
+  uint32_t mCapacity;
+
+  VkDescriptorSetLayout mDescriptorSetLayout{};
+  VkDescriptorPool mDescriptorPool{};
+  VkDescriptorSet mDescriptorSet{};
+
+  std::vector<mem::Texture> mTextures;
+  // single layer views of registered array textures
+  std::vector<VkImageView> mLayerViews;
+  uint32_t mTextureCount{0};
+
+  uint32_t writeDescriptor(VkImageView const &imageView, VkSampler const &sampler);
+
+public:
+  static constexpr uint32_t Binding = 0;
+  static constexpr uint32_t MaxTextures = 4096;
+
+  TextureRegistry() = delete;
+  TextureRegistry(GPU const &gpu, mem::MemoryManager &memoryManager);
+  TextureRegistry(TextureRegistry const &) = delete;
+  ~TextureRegistry();
+
+  void operator=(TextureRegistry const &) = delete;
+
+  // takes ownership of the texture and returns its index
+  [[nodiscard]] uint32_t registerTexture(mem::Texture const &texture);
+  // takes ownership of the array texture and registers each layer on its own, layer i gets the
+  // returned index + i
+  [[nodiscard]] uint32_t registerTextureLayers(mem::Texture const &arrayTexture);
+  // destroys every registered texture, the GPU must not be using them anymore
+  void clear();
+
+  [[nodiscard]] VkDescriptorSetLayout getDescriptorSetLayout() const;
+  [[nodiscard]] VkDescriptorSet getDescriptorSet() const;
+  [[nodiscard]] uint32_t getTextureCount() const;
+  [[nodiscard]] uint32_t getCapacity() const;
+};
+} // namespace cbl::gfx
@@ -4,4 +4,10 @@
 
 namespace cbl::gfx {
 void validateVkResult(VkResult const &result);
+
+// color + depth render pass used to draw the scene, whether it ends up on screen or offscreen
+[[nodiscard]] VkRenderPass createSceneRenderPass(VkDevice const &device,
+                                                 VkFormat const &colorFormat,
+                                                 VkFormat const &depthFormat,
+                                                 VkImageLayout const &colorFinalLayout);
 } // namespace cbl::gfx
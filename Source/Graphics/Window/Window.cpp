@@ -36,9 +36,9 @@ Window::~Window() {
 
 void Window::initImgui() { ImGui_ImplSDL2_InitForVulkan(mSDLWindow); }
 
-void Window::update() {
+void Window::update(FrameArena &arena) {
   SDL_Event event{};
-  std::vector<SDL_Event> events;
+  FrameVector<SDL_Event> events{FrameAllocator<SDL_Event>{arena}};
   while (SDL_PollEvent(&event)) {
     events.push_back(event);
     ImGui_ImplSDL2_ProcessEvent(&event);
@@ -6,6 +6,7 @@
 #include <SDL2/SDL.h>
 #include <vulkan/vulkan.h>
 
+#include "Core/Memory/FrameArena/FrameArena.hpp"
 #include "Math/Vector/Vector2/Vector2.hpp"
 
 namespace cbl::gfx {
@@ -24,7 +25,8 @@ public:
 
   void initImgui();
 
-  void update();
+  // polls the pending events, collected in the frame arena
+  void update(FrameArena &arena);
 
   [[nodiscard]] bool isOpen() const;
 
@@ -0,0 +1,26 @@
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "Graphics/Memory/TextureBundle/TextureBundle.hpp"
+
+int main(int argc, char *argv[]) {
+  // usage: CobblestoneTextureBaker <output.cbtx> <layer0.png> [layer1.png ...]
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0] << " <output.cbtx> <layer0.png> [layer1.png ...]\n";
+    return EXIT_FAILURE;
+  }
+
+  std::vector<std::filesystem::path> const imagePaths{argv + 2, argv + argc};
+
+  try {
+    cbl::gfx::mem::TextureBundle::bake(imagePaths, argv[1]);
+  } catch (std::exception const &exception) {
+    std::cerr << exception.what() << "\n";
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}